@@ -2,8 +2,9 @@ build/code/boss_fight/%.o: N64_CXXFLAGS += -std=gnu++20 -fno-exceptions -O2
 
 BOSS_FIGHT_assets_coll = $(wildcard assets/boss_fight/*.coll)
 BOSS_FIGHT_assets_scene = $(wildcard assets/boss_fight/*.scene)
+BOSS_FIGHT_assets_grass = $(wildcard assets/boss_fight/grass/*.grass)
 
-BOSS_FIGHT_assets_png = $(wildcard assets/boss_fight/*.png) $(wildcard assets/boss_fight/grass/*.png) \
+BOSS_FIGHT_assets_png = $(wildcard assets/boss_fight/*.png) $(wildcard assets/boss_fight/grass/*.i8.png) \
 	$(wildcard assets/boss_fight/ui/*.png) $(wildcard assets/boss_fight/ptx/*.png) \
 	$(wildcard assets/boss_fight/obj/*.png)
 
@@ -14,6 +15,7 @@ BOSS_FIGHT_assets_wav = $(wildcard assets/boss_fight/sfx/*.wav)
 
 BOSS_FIGHT_assets_conv = $(patsubst assets/%,filesystem/%,$(BOSS_FIGHT_assets_coll)) \
               			 $(patsubst assets/%,filesystem/%,$(BOSS_FIGHT_assets_scene)) \
+              			 $(patsubst assets/%,filesystem/%,$(BOSS_FIGHT_assets_grass)) \
               			 $(patsubst assets/%,filesystem/%,$(BOSS_FIGHT_assets_png:%.png=%.sprite)) \
               			 $(patsubst assets/%,filesystem/%,$(BOSS_FIGHT_assets_glb:%.glb=%.t3dm)) \
               			 $(patsubst assets/%,filesystem/%,$(BOSS_FIGHT_assets_ttf:%.ttf=%.font64)) \
@@ -26,7 +28,22 @@ BOSS_FIGHT_assets_conv = $(patsubst assets/%,filesystem/%,$(BOSS_FIGHT_assets_co
 
 #assets/boss_fight/map.coll: assets/boss_fight/map.glb
 #	@echo "    [COLL] $@"
-#	code/boss_fight/tools/gltf_to_coll "$<" assets/boss_fight/map.coll
+#	code/boss_fight/tools/gltf_to_coll --tri-data "$<" assets/boss_fight/map.coll
+
+# Both converters also take several <glb> <output> pairs at once, converting them in parallel (-j threads),
+# and with "-c <cache>" skip every output whose glTF and buffers are unchanged since the last run:
+#	code/boss_fight/tools/gltf_to_coll -c code/boss_fight/tools/build/coll.cache assets/boss_fight/map.glb assets/boss_fight/map.coll ...
+# "--tri-data" stores precomputed per-triangle data (normal, plane, edges, floor/wall) used by the collision checks.
+# "--wide-bvh" writes a 4-wide BVH instead, "--bvh-quality=low|medium|high", "--bvh-min-leaf=N", "--bvh-max-leaf=N"
+# and "--bvh-node-cost=F" tune the builder, the BVH report printed for each sub-mesh shows their effect.
+# Compare the results with the host benchmark ("make bench_bvh" in code/boss_fight/tools), optionally replaying
+# queries logged by the game with Coll::BVH_LOG_QUERIES:
+#	code/boss_fight/tools/bench_bvh [-q log.txt] map.coll map_wide.coll ...
+
+# Grass heightmaps are baked into particles, the game never loads the images themselves:
+#assets/boss_fight/grass/%.grass: assets/boss_fight/grass/%.rgba32.png
+#	@echo "    [GRASS] $@"
+#	code/boss_fight/tools/png_to_grass "$<" "$@"
 
 filesystem/boss_fight/%.coll: assets/boss_fight/%.coll
 	@mkdir -p $(dir $@)
@@ -38,6 +55,11 @@ filesystem/boss_fight/%.scene: assets/boss_fight/%.scene
 	@echo "    [SCENE] $@"
 	$(N64_BINDIR)/mkasset -c 2 -w 256 -o filesystem/boss_fight "$<"
 
+filesystem/boss_fight/grass/%.grass: assets/boss_fight/grass/%.grass
+	@mkdir -p $(dir $@)
+	@echo "    [GRASS] $@"
+	$(N64_BINDIR)/mkasset -c 2 -o filesystem/boss_fight/grass "$<"
+
 BOSS_FIGHT_AUDIOCONV_FLAGS = --wav-resample 22050 --wav-mono
 
 filesystem/boss_fight/bgm/%.wav64: assets/boss_fight/bgm/%.mp3
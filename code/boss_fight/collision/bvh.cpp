@@ -6,62 +6,116 @@
 #include "../debug/debugDraw.h"
 
 namespace {
-  const int16_t *ctxData;
-  const Coll::AABB *ctxAABB;
-  const Coll::IVec3 *ctxRayPos;
-  Coll::BVHResult *ctxRes;
+  /**
+   * Adds the triangle range of a leaf to the result.
+   * @return false once the result is full
+   */
+  inline bool addLeaf(uint16_t value, Coll::BVHResult &res)
+  {
+    int triIndex = value >> 4;
+    int triIndexEnd = triIndex + (value & 0b1111);
+    while(triIndex < triIndexEnd) {
+      if(res.count >= Coll::MAX_RESULT_COUNT)return false;
+      res.triIndex[res.count++] = triIndex++;
+    }
+    return true;
+  }
 
-  void queryNodeAABB(const Coll::BVHNode *node)
+  /**
+   * Appends the triangle range of a leaf to the result.
+   * @return always true, there is no limit
+   */
+  inline bool addLeaf(uint16_t value, std::vector<uint16_t> &res)
   {
-    if(!node->aabb.vsAABB(*ctxAABB))return;
+    int triIndex = value >> 4;
+    int triIndexEnd = triIndex + (value & 0b1111);
+    while(triIndex < triIndexEnd)res.push_back(triIndex++);
+    return true;
+  }
 
-    int dataCount = node->value & 0b1111;
-    int offset = (int16_t)node->value >> 4;
+  template<typename TEST, typename RESULT>
+  void queryBinary(const Coll::BVH &bvh, TEST test, RESULT &res)
+  {
+    const Coll::BVHNode *stack[Coll::BVH_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = bvh.nodes;
 
-    if(dataCount == 0) {
-      queryNodeAABB(&node[offset]);
-      queryNodeAABB(&node[offset + 1]);
-      return;
-    }
+    while(stackSize > 0)
+    {
+      const Coll::BVHNode *node = stack[--stackSize];
+      if(!test(node->aabb))continue;
+
+      if((node->value & 0b1111) == 0) {
+        // push the right child first, so the left one is visited first (same order as recursion)
+        int offset = (int16_t)node->value >> 4;
+        stack[stackSize++] = &node[offset + 1];
+        stack[stackSize++] = &node[offset];
+        continue;
+      }
 
-    int offsetEnd = offset + dataCount;
-    while(offset < offsetEnd && ctxRes->count < Coll::MAX_RESULT_COUNT) {
-      ctxRes->triIndex[ctxRes->count++] = ctxData[offset++];
+      if(!addLeaf(node->value, res))return;
     }
   }
 
-  void queryNodeRaycastFloor(const Coll::BVHNode *node)
+  template<typename TEST, typename RESULT>
+  void queryWide(const Coll::BVH &bvh, TEST test, RESULT &res)
   {
-    if(!node->aabb.vs2DPointY(*ctxRayPos))return;
+    const Coll::BVHNode4 *stack[Coll::BVH_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = (const Coll::BVHNode4*)bvh.nodes;
 
-    int dataCount = node->value & 0b1111;
-    int offset = (int16_t)node->value >> 4;
-
-    if(dataCount == 0) {
-      queryNodeRaycastFloor(&node[offset]);
-      queryNodeRaycastFloor(&node[offset + 1]);
-      return;
+    while(stackSize > 0)
+    {
+      const Coll::BVHNode4 *node = stack[--stackSize];
+      for(int c=3; c>=0; --c)
+      {
+        if(!test(node->aabb[c]))continue;
+        uint16_t value = node->value[c];
+        if((value & 0b1111) == 0) {
+          stack[stackSize++] = &node[value >> 4];
+        } else if(!addLeaf(value, res)) {
+          return;
+        }
+      }
     }
+  }
 
-    int offsetEnd = offset + dataCount;
-    while(offset < offsetEnd && ctxRes->count < Coll::MAX_RESULT_COUNT) {
-      ctxRes->triIndex[ctxRes->count++] = ctxData[offset++];
+  template<typename TEST, typename RESULT>
+  inline void query(const Coll::BVH &bvh, TEST test, RESULT &res)
+  {
+    if(bvh.flags & Coll::BVH_FLAG_WIDE) {
+      queryWide(bvh, test, res);
+    } else {
+      queryBinary(bvh, test, res);
     }
   }
 }
 
 void Coll::BVH::vsAABB(const Coll::AABB &aabb, BVHResult &res) const {
-  ctxData = (int16_t*)&nodes[nodeCount]; // data starts right after nodes;
-  ctxAABB = &aabb;
-  ctxRes = &res;
-  queryNodeAABB(nodes);
+  if constexpr(BVH_LOG_QUERIES) {
+    debugf("BVHQ S %d %d %d %d %d %d\n",
+      aabb.min.v[0], aabb.min.v[1], aabb.min.v[2], aabb.max.v[0], aabb.max.v[1], aabb.max.v[2]);
+  }
+  query(*this, [&aabb](const Coll::AABB &nodeAABB) {
+    return nodeAABB.vsAABB(aabb);
+  }, res);
 }
 
-void Coll::BVH::raycastFloor(const Coll::IVec3 &pos, Coll::BVHResult &res) const {
-  ctxData = (int16_t*)&nodes[nodeCount]; // data starts right after nodes;
-  ctxRayPos = &pos;
-  ctxRes = &res;
-  queryNodeRaycastFloor(nodes);
+void Coll::BVH::vsAABB(const Coll::AABB &aabb, std::vector<uint16_t> &res) const {
+  if constexpr(BVH_LOG_QUERIES) {
+    debugf("BVHQ S %d %d %d %d %d %d\n",
+      aabb.min.v[0], aabb.min.v[1], aabb.min.v[2], aabb.max.v[0], aabb.max.v[1], aabb.max.v[2]);
+  }
+  query(*this, [&aabb](const Coll::AABB &nodeAABB) {
+    return nodeAABB.vsAABB(aabb);
+  }, res);
 }
 
-
+void Coll::BVH::raycastFloor(const Coll::IVec3 &pos, Coll::BVHResult &res) const {
+  if constexpr(BVH_LOG_QUERIES) {
+    debugf("BVHQ F %d %d %d\n", pos.v[0], pos.v[1], pos.v[2]);
+  }
+  query(*this, [&pos](const Coll::AABB &nodeAABB) {
+    return nodeAABB.vs2DPointY(pos);
+  }, res);
+}
@@ -10,8 +10,16 @@ namespace Coll
 {
   constexpr int MAX_RESULT_COUNT = 32;
 
+  // traversal stack, gltf_to_coll rejects (splits) trees that would need more
+  constexpr int BVH_STACK_SIZE = 64;
+
+  constexpr uint16_t BVH_FLAG_WIDE = 1 << 0;
+
+  // logs every query ("BVHQ ..." lines), save them from the log to replay them with tools/bench_bvh
+  constexpr bool BVH_LOG_QUERIES = false;
+
   struct BVHResult {
-    int16_t triIndex[MAX_RESULT_COUNT]{};
+    uint16_t triIndex[MAX_RESULT_COUNT]{};
     int16_t count{};
 
     void reset() { count = 0; }
@@ -23,18 +31,28 @@ namespace Coll
   };
   static_assert(sizeof(BVHNode) == (7 * sizeof(int16_t)));
 
+  // 4-wide node, bounds of all children are stored in the parent
+  struct BVHNode4 {
+    AABB aabb[4]{};
+    uint16_t value[4]{};
+  };
+  static_assert(sizeof(BVHNode4) == (28 * sizeof(int16_t)));
+
+  // leaves reference a range of triangles directly, the mesh stores them in leaf order
   struct BVH {
     uint16_t nodeCount;
-    uint16_t dataCount;
-    BVHNode nodes[];
-    // uint16_t data[];
+    uint16_t flags;
+    BVHNode nodes[]; // or BVHNode4 if BVH_FLAG_WIDE is set
 
     void vsAABB(const AABB &aabb, BVHResult &res) const;
 
+    // same as above without a limit, triangles are appended to 'res'
+    void vsAABB(const AABB &aabb, std::vector<uint16_t> &res) const;
+
     inline void vsSphere(const Sphere &sphere, BVHResult &res) const {
       vsAABB((sphere * 64.0f).toAABB(), res);
     }
 
     void raycastFloor(const Coll::IVec3 &pos, BVHResult &res) const;
   };
-}
\ No newline at end of file
+}
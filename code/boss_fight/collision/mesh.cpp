@@ -84,6 +84,26 @@ namespace {
 		return {1.0f - u-v, v, u};
   }
 
+  // same as above, with the terms only depending on the triangle precomputed
+  T3DVec3 getTriBaryCoord(const T3DVec3 &p, const T3DVec3 &a, const T3DVec3 &b, const T3DVec3 &c, const Coll::TriData &data)
+  {
+    if(data.baryCoeff[0] == 0.0f) {
+      return T3DVec3{-1.0f, -1.0f, -1.0f};
+    }
+
+    const auto v0 = c - a;
+    const auto v1 = b - a;
+    const auto v2 = p - a;
+
+    const auto dot02 = t3d_vec3_dot(&v0, &v2);
+    const auto dot12 = t3d_vec3_dot(&v1, &v2);
+
+    const float u = data.baryCoeff[0] * dot02 - data.baryCoeff[1] * dot12;
+    const float v = data.baryCoeff[2] * dot12 - data.baryCoeff[1] * dot02;
+
+    return {1.0f - u-v, v, u};
+  }
+
   T3DVec3 closestPointOnLine(const T3DVec3 &p, const T3DVec3 &a, const T3DVec3 &b)
   {
     const T3DVec3 lineVec = b - a;
@@ -96,6 +116,15 @@ namespace {
 		return a + (lineDir * clamp(pointDist, 0.0f, length));
   }
 
+  // same as above without a square root, 'invLen2' is 0 for zero-length lines
+  T3DVec3 closestPointOnLine(const T3DVec3 &p, const T3DVec3 &a, const T3DVec3 &b, float invLen2)
+  {
+    const T3DVec3 lineVec = b - a;
+    const T3DVec3 pointToA = p - a;
+    const float t = t3d_vec3_dot(&pointToA, &lineVec) * invLen2;
+    return a + (lineVec * clamp(t, 0.0f, 1.0f));
+  }
+
   Coll::CollInfo triVsSphere(const Coll::Sphere &sphere, const Coll::Triangle &face)
   {
     const auto &bcsPos = sphere.center;
@@ -105,14 +134,18 @@ namespace {
     const auto &vert2 = *face.v[2];
 
     // Face tests
-    float planeDist = pointPlaneDistance(bcsPos, vert0, face.normal);
+    float planeDist = face.data
+      ? (t3d_vec3_dot(&bcsPos, &face.normal) - face.data->planeDist)
+      : pointPlaneDistance(bcsPos, vert0, face.normal);
     // when we are behind the face (negative), half the distance that is needed to snap back in
     float planeDistAbs = planeDist < 0.0f ? fabsf(planeDist*2.0f) : planeDist;
     if(planeDistAbs < sphere.radius)
     {
       T3DVec3 contactPoint = bcsPos + face.normal * -planeDist;
 
-      auto baryPos = getTriBaryCoord(bcsPos, vert0, vert1, vert2);
+      auto baryPos = face.data
+        ? getTriBaryCoord(bcsPos, vert0, vert1, vert2, *face.data)
+        : getTriBaryCoord(bcsPos, vert0, vert1, vert2);
       const bool isInTri = (baryPos.v[0] >= 0.0f) && (baryPos.v[1] >= 0.0f)
         && ((baryPos.v[0] + baryPos.v[1]) <= 1.0f);
 
@@ -128,9 +161,16 @@ namespace {
     }
 
     // Edge test
-    const auto closestPoint1 = closestPointOnLine(bcsPos, vert0, vert1);
-    const auto closestPoint2 = closestPointOnLine(bcsPos, vert1, vert2);
-    const auto closestPoint3 = closestPointOnLine(bcsPos, vert2, vert0);
+    T3DVec3 closestPoint1, closestPoint2, closestPoint3;
+    if(face.data) {
+      closestPoint1 = closestPointOnLine(bcsPos, vert0, vert1, face.data->edgeInvLen2[0]);
+      closestPoint2 = closestPointOnLine(bcsPos, vert1, vert2, face.data->edgeInvLen2[1]);
+      closestPoint3 = closestPointOnLine(bcsPos, vert2, vert0, face.data->edgeInvLen2[2]);
+    } else {
+      closestPoint1 = closestPointOnLine(bcsPos, vert0, vert1);
+      closestPoint2 = closestPointOnLine(bcsPos, vert1, vert2);
+      closestPoint3 = closestPointOnLine(bcsPos, vert2, vert0);
+    }
 
     const auto closestDist1 = t3d_vec3_distance2(&bcsPos, &closestPoint1);
     const auto closestDist2 = t3d_vec3_distance2(&bcsPos, &closestPoint2);
@@ -168,13 +208,134 @@ namespace {
     return (b0 == b1 && b1 == b2);
   }
 
-  T3DVec3 getTrianglePosFromXZ(const T3DVec3 &pos, const T3DVec3 &vert, const T3DVec3 &normal)
+  T3DVec3 getTrianglePosFromXZ(const T3DVec3 &pos, float planeDist, const T3DVec3 &normal)
   {
-    const float t = (t3d_vec3_dot(normal, pos) - t3d_vec3_dot(normal, vert)) / normal.v[1];
+    const float t = (t3d_vec3_dot(normal, pos) - planeDist) / normal.v[1];
     return pos + T3DVec3{{0, -t, 0}};
   }
 }
 
+Coll::Triangle Coll::Mesh::getTriangle(uint32_t t) const
+{
+  int idxA = indices[t*3];
+  int idxB = indices[t*3+1];
+  int idxC = indices[t*3+2];
+
+  Triangle tri{
+    .v = {&verts[idxA], &verts[idxB], &verts[idxC]},
+  };
+
+  if(triData) {
+    tri.data = &triData[t];
+    tri.normal = tri.data->normal;
+  } else {
+    auto &norm = normals[t];
+    tri.normal = {{
+      (float)norm.v[0] * (1.0f / 32767.0f),
+      (float)norm.v[1] * (1.0f / 32767.0f),
+      (float)norm.v[2] * (1.0f / 32767.0f)
+    }};
+  }
+  return tri;
+}
+
+bool Coll::MeshInstance::update()
+{
+  bool changed = false;
+  for(int i=0; i<3; ++i) {
+    changed |= pos.v[i] != lastPos.v[i] || scale.v[i] != lastScale.v[i];
+  }
+  for(int i=0; i<4; ++i)changed |= rot.v[i] != lastRot.v[i];
+  if(!changed)return false;
+
+  lastPos = pos;
+  lastScale = scale;
+  lastRot = rot;
+
+  isTransformed = scale.v[0] != 1.0f || scale.v[1] != 1.0f || scale.v[2] != 1.0f
+    || rot.v[0] != 0.0f || rot.v[1] != 0.0f || rot.v[2] != 0.0f;
+
+  // columns of the rotation matrix
+  float x = rot.v[0], y = rot.v[1], z = rot.v[2], w = rot.v[3];
+  axis[0] = {{1.0f - 2.0f*(y*y + z*z), 2.0f*(x*y + w*z), 2.0f*(x*z - w*y)}};
+  axis[1] = {{2.0f*(x*y - w*z), 1.0f - 2.0f*(x*x + z*z), 2.0f*(y*z + w*x)}};
+  axis[2] = {{2.0f*(x*z + w*y), 2.0f*(y*z - w*x), 1.0f - 2.0f*(x*x + y*y)}};
+
+  for(int i=0; i<3; ++i)invScale.v[i] = 1.0f / scale.v[i];
+  return true;
+}
+
+T3DVec3 Coll::MeshInstance::toWorld(const T3DVec3 &posLocal) const
+{
+  if(!isTransformed)return posLocal + pos;
+  return pos
+    + axis[0] * (posLocal.v[0] * scale.v[0])
+    + axis[1] * (posLocal.v[1] * scale.v[1])
+    + axis[2] * (posLocal.v[2] * scale.v[2]);
+}
+
+T3DVec3 Coll::MeshInstance::toWorldNormal(const T3DVec3 &normalLocal) const
+{
+  if(!isTransformed)return normalLocal;
+  // inverse-transpose, keeps normals correct with non-uniform scaling
+  auto res = axis[0] * (normalLocal.v[0] * invScale.v[0])
+    + axis[1] * (normalLocal.v[1] * invScale.v[1])
+    + axis[2] * (normalLocal.v[2] * invScale.v[2]);
+  t3d_vec3_norm(res);
+  return res;
+}
+
+T3DVec3 Coll::MeshInstance::toLocal(const T3DVec3 &posWorld) const
+{
+  auto diff = posWorld - pos;
+  if(!isTransformed)return diff;
+  return {{
+    t3d_vec3_dot(axis[0], diff) * invScale.v[0],
+    t3d_vec3_dot(axis[1], diff) * invScale.v[1],
+    t3d_vec3_dot(axis[2], diff) * invScale.v[2]
+  }};
+}
+
+void Coll::MeshInstance::toLocalBounds(T3DVec3 &min, T3DVec3 &max) const
+{
+  if(!isTransformed) {
+    min -= pos;
+    max -= pos;
+    return;
+  }
+
+  auto center = toLocal((min + max) * 0.5f);
+  auto halfSize = (max - min) * 0.5f;
+  T3DVec3 halfSizeLocal;
+  for(int i=0; i<3; ++i) {
+    halfSizeLocal.v[i] = (
+      fabsf(axis[i].v[0]) * halfSize.v[0] +
+      fabsf(axis[i].v[1]) * halfSize.v[1] +
+      fabsf(axis[i].v[2]) * halfSize.v[2]
+    ) * fabsf(invScale.v[i]);
+  }
+  min = center - halfSizeLocal;
+  max = center + halfSizeLocal;
+}
+
+Coll::Triangle Coll::MeshInstance::getTriangle(const Mesh &mesh, uint32_t t, T3DVec3 verts[3]) const
+{
+  auto tri = mesh.getTriangle(t);
+  for(int i=0; i<3; ++i) {
+    verts[i] = toWorld(*tri.v[i]);
+    tri.v[i] = &verts[i];
+  }
+  tri.normal = toWorldNormal(tri.normal);
+  tri.data = nullptr; // precomputed in mesh space
+  return tri;
+}
+
+bool Coll::Mesh::isFloor(uint32_t t) const
+{
+  if(triData)return triData[t].type & TriType::FLOOR;
+  return normals[t].v[1] > (int16_t)(0x7FFF * FLOOR_ANGLE);
+}
+
 Coll::CollInfo Coll::Mesh::vsSphere(const Coll::Sphere &sphere, const Coll::Triangle &triangle) const {
   return triVsSphere(sphere, triangle);
 }
@@ -197,7 +358,8 @@ Coll::CollInfo Coll::Mesh::vsFloorRay(const T3DVec3 &rayStart, const Coll::Trian
       return {.collCount = 0};
     }
 
-    auto hitPos = getTrianglePosFromXZ(rayStart, vert0, face.normal);
+    float planeDist = face.data ? face.data->planeDist : t3d_vec3_dot(face.normal, vert0);
+    auto hitPos = getTrianglePosFromXZ(rayStart, planeDist, face.normal);
     if(hitPos.v[1] > rayStart.v[1]) {
       return {.collCount = 0};
     }
@@ -21,19 +21,50 @@ namespace Coll
     T3DVec3 *verts{};
     IVec3 *normals{};
     BVH* bvh{};
-    // data follows here: indices, normals, verts, BVH
-    int16_t indices[];
+    Mesh* next{}; // large meshes are split into sub-meshes stored back to back in the same file
+    TriData* triData{}; // optional, nullptr if not present
+    // data follows here: indices, normals, verts, BVH, triData
+    uint16_t indices[];
 
     [[nodiscard]] Coll::CollInfo vsSphere(const Coll::Sphere &sphere, const Triangle& triangle) const;
     [[nodiscard]] Coll::CollInfo vsFloorRay(const T3DVec3 &pos, const Triangle& triangle) const;
 
+    [[nodiscard]] Coll::Triangle getTriangle(uint32_t t) const;
+    [[nodiscard]] bool isFloor(uint32_t t) const;
+
     static Mesh* load(const std::string &path);
   };
 
+  /**
+   * Placement of a mesh in the scene, the same mesh can be used by any number of instances.
+   * Queries are moved into mesh space, instances that are only translated skip all rotation/scaling.
+   * Changes to 'pos', 'scale' and 'rot' are picked up by the next Scene::update().
+   */
   struct MeshInstance {
     Mesh *mesh{};
     T3DVec3 pos{0.0f, 0.0f, 0.0f};
     T3DVec3 scale{1.0f, 1.0f, 1.0f};
     T3DQuat rot{0.0f, 0.0f, 0.0f, 1.0f};
+
+    // derived from the values above in update()
+    T3DVec3 axis[3]{{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}}; // rotated unit axes
+    T3DVec3 invScale{1.0f, 1.0f, 1.0f};
+    bool isTransformed{false}; // rotated or scaled
+    T3DVec3 lastPos{};
+    T3DVec3 lastScale{};
+    T3DQuat lastRot{};
+
+    // @return true if the transform changed since the last call
+    bool update();
+
+    [[nodiscard]] T3DVec3 toWorld(const T3DVec3 &posLocal) const;
+    [[nodiscard]] T3DVec3 toWorldNormal(const T3DVec3 &normalLocal) const;
+    [[nodiscard]] T3DVec3 toLocal(const T3DVec3 &posWorld) const;
+
+    // converts a world space AABB into one that contains it in mesh space
+    void toLocalBounds(T3DVec3 &min, T3DVec3 &max) const;
+
+    // triangle 't' of 'mesh' in world space, the transformed vertices are stored in 'verts'
+    [[nodiscard]] Coll::Triangle getTriangle(const Mesh &mesh, uint32_t t, T3DVec3 verts[3]) const;
   };
 }
\ No newline at end of file
@@ -3,29 +3,46 @@
 * @license MIT
 */
 #include "navPoints.h"
+#include <algorithm>
+
+namespace {
+  bool isBeforeX(const T3DVec3 &point, float x) {
+    return point.v[0] < x;
+  }
+}
 
 void Coll::NavPoints::addPoint(const T3DVec3 &point) {
   // insert point into the list sorted by X-coord
-  auto it = points.begin();
-  while(it != points.end() && it->v[0] < point.v[0]) {
-    ++it;
-  }
+  auto it = std::lower_bound(points.begin(), points.end(), point.v[0], isBeforeX);
   points.insert(it, point);
 }
 
-Coll::NavPointsRes Coll::NavPoints::getClosest(const T3DVec3 &pos, float deltaX) const {
+Coll::NavPointsRes Coll::NavPoints::getClosest(const T3DVec3 &pos, float deltaX, float maxDist2) const {
+  NavPointsRes res{};
+  getClosest(&pos, &res, 1, deltaX, maxDist2);
+  return res;
+}
+
+void Coll::NavPoints::getClosest(const T3DVec3 *pos, NavPointsRes *res, uint32_t count, float deltaX, float maxDist2) const
+{
+  for(uint32_t i=0; i<count; ++i)
+  {
+    // ignore points behind the position, anything in front is sorted by X-distance
+    float minX = pos[i].x + deltaX;
+    auto it = std::lower_bound(points.begin(), points.end(), minX, isBeforeX);
 
-  float closestDist2 = 999999999.0f;
-  const T3DVec3 *closestPoint = nullptr;
-  for(const auto &point : points) {
-    if(point.x < (pos.x+deltaX))continue; // ignore points behind the player
+    float closestDist2 = maxDist2;
+    const T3DVec3 *closestPoint = nullptr;
+    for(; it != points.end(); ++it) {
+      float distX = it->x - pos[i].x;
+      if(distX > 0.0f && distX*distX >= closestDist2)break; // no point further on can be closer
 
-    float dist2 = t3d_vec3_len2(point - pos);
-    if(dist2 < closestDist2) {
-      closestDist2 = dist2;
-      closestPoint = &point;
+      float dist2 = t3d_vec3_len2(*it - pos[i]);
+      if(dist2 < closestDist2) {
+        closestDist2 = dist2;
+        closestPoint = &(*it);
+      }
     }
+    res[i] = {closestPoint, closestDist2};
   }
-
-  return {closestPoint, closestDist2};
 }
@@ -20,6 +20,14 @@ namespace Coll
     std::vector<T3DVec3> points{};
 
     void addPoint(const T3DVec3 &point);
-    NavPointsRes getClosest(const T3DVec3 &pos, float deltaX) const;
+
+    /**
+     * Closest point at least 'deltaX' ahead of 'pos' (in X).
+     * Only points within sqrt(maxDist2) are checked, which bounds the search to a window around 'pos'.
+     */
+    NavPointsRes getClosest(const T3DVec3 &pos, float deltaX, float maxDist2 = 999999999.0f) const;
+
+    // same as above for multiple positions in one pass, 'res' must hold 'count' entries
+    void getClosest(const T3DVec3 *pos, NavPointsRes *res, uint32_t count, float deltaX, float maxDist2 = 999999999.0f) const;
   };
-}
\ No newline at end of file
+}
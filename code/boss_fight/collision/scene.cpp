@@ -8,13 +8,34 @@
 
 namespace {
   constexpr float MIN_PENETRATION = 0.00005f;
-  constexpr float FLOOR_ANGLE = 0.7f;
 
-  constexpr bool isFloor(const Coll::IVec3 &normal) {
-    return normal.v[1] > (int16_t)(0x7FFF * FLOOR_ANGLE);
-  }
   constexpr bool isFloor(const T3DVec3 &normal) {
-    return normal.v[1] > FLOOR_ANGLE;
+    return normal.v[1] > Coll::FLOOR_ANGLE;
+  }
+
+  constexpr float MAX_HEIGHT = 99999.0f;
+
+  Coll::AABB toBVHSpace(const T3DVec3 &min, const T3DVec3 &max)
+  {
+    Coll::AABB res{};
+    for(int i=0; i<3; ++i) {
+      res.min.v[i] = (int16_t)fmaxf(floorf(min.v[i] * 64.0f), INT16_MIN);
+      res.max.v[i] = (int16_t)fminf(ceilf(max.v[i] * 64.0f), INT16_MAX);
+    }
+    return res;
+  }
+
+  // world space AABB into the int16 space of the BVH of an instance
+  Coll::AABB toBVHSpace(const Coll::MeshInstance &meshInst, T3DVec3 min, T3DVec3 max)
+  {
+    meshInst.toLocalBounds(min, max);
+    return toBVHSpace(min, max);
+  }
+
+  bool isFloorTri(const Coll::MeshInstance &meshInst, const Coll::Mesh &mesh, uint32_t t)
+  {
+    if(!meshInst.isTransformed)return mesh.isFloor(t);
+    return isFloor(meshInst.toWorldNormal(mesh.getTriangle(t).normal));
   }
 }
 
@@ -34,68 +55,197 @@ Coll::CollInfo Coll::Scene::vsSphere(Coll::Sphere &sphere, const T3DVec3 &veloci
     .normal = T3DVec3{0.0f, 0.0f, 0.0f},
     .collCount = 0,
   };
-  Coll::BVHResult bvhRes{};
 
-  for(int s=0; s<steps; ++s)
+  // collect the triangles near the whole motion once, all steps then only test those.
+  // the margin of an extra radius covers most pushes by collisions, steps leaving it query the BVH again
+  auto ticksBvhStart = get_ticks();
+  auto posEnd = sphere.center + velocityStep * (float)steps;
+  float margin = sphere.radius;
+  auto sweptMin = T3DVec3{{
+    fminf(sphere.center.v[0], posEnd.v[0]) - margin,
+    fminf(sphere.center.v[1], posEnd.v[1]) - margin,
+    fminf(sphere.center.v[2], posEnd.v[2]) - margin
+  }};
+  auto sweptMax = T3DVec3{{
+    fmaxf(sphere.center.v[0], posEnd.v[0]) + margin,
+    fmaxf(sphere.center.v[1], posEnd.v[1]) + margin,
+    fmaxf(sphere.center.v[2], posEnd.v[2]) + margin
+  }};
+
+  sweptMeshes.clear();
+  sweptTris.clear();
+  sweptVerts.clear();
+  for(auto meshInst : meshes)
   {
-    sphere.center = sphere.center + velocityStep;
+    auto sweptAABB = toBVHSpace(*meshInst, sweptMin, sweptMax);
 
-    for(auto meshInst : meshes)
-    {
-      auto &mesh = *meshInst->mesh;
+    // triangles of rotated/scaled instances are tested in world space
+    bool inWorld = meshInst->isTransformed;
+    auto testAABB = inWorld ? toBVHSpace(sweptMin, sweptMax) : sweptAABB;
 
-      auto sphereLocal = sphere;
-      sphereLocal.center = sphereLocal.center - meshInst->pos;
+    for(auto subMesh = meshInst->mesh; subMesh; subMesh = subMesh->next)
+    {
+      bvhTris.clear();
+      subMesh->bvh->vsAABB(sweptAABB, bvhTris);
+
+      sweptMeshes.push_back({subMesh, meshInst, testAABB, (uint32_t)sweptTris.size(), 0, inWorld});
+      for(auto t : bvhTris) {
+        Triangle tri;
+        if(inWorld) {
+          sweptVerts.resize(sweptVerts.size() + 3);
+          tri = meshInst->getTriangle(*subMesh, t, &sweptVerts[sweptVerts.size() - 3]);
+        } else {
+          tri = subMesh->getTriangle(t);
+        }
 
-      auto ticksBvhStart = get_ticks();
-      bvhRes.reset();
-      mesh.bvh->vsSphere(sphereLocal, bvhRes);
-      ticksBVH += get_ticks() - ticksBvhStart;
-      if(bvhRes.count >= Coll::MAX_RESULT_COUNT-1) {
-        //debugf("BVH count: %d\n", bvhRes.count);
+        // bounds in the test space, to skip the triangle in steps that can't touch it
+        for(int i=0; i<3; ++i) {
+          float min = fminf(fminf(tri.v[0]->v[i], tri.v[1]->v[i]), tri.v[2]->v[i]) * 64.0f;
+          float max = fmaxf(fmaxf(tri.v[0]->v[i], tri.v[1]->v[i]), tri.v[2]->v[i]) * 64.0f;
+          tri.aabb.min.v[i] = (int16_t)fmaxf(floorf(min), INT16_MIN);
+          tri.aabb.max.v[i] = (int16_t)fminf(ceilf(max), INT16_MAX);
+        }
+        sweptTris.push_back(tri);
       }
+      sweptMeshes.back().triEnd = sweptTris.size();
+    }
+  }
 
-      for(int b=0; b<bvhRes.count; ++b) {
-        uint32_t t = bvhRes.triIndex[b];
-
-        int idxA = mesh.indices[t*3];
-        int idxB = mesh.indices[t*3+1];
-        int idxC = mesh.indices[t*3+2];
-        auto &norm = mesh.normals[t];
-
-        Triangle tri{
-          .normal = {{
-           (float)norm.v[0] * (1.0f / 32767.0f),
-           (float)norm.v[1] * (1.0f / 32767.0f),
-           (float)norm.v[2] * (1.0f / 32767.0f)
-          }},
-          .v = {&mesh.verts[idxA], &mesh.verts[idxB], &mesh.verts[idxC]}
-        };
+  // 'sweptVerts' may have moved while growing, point the world space triangles to their final place
+  uint32_t vertIdx = 0;
+  for(auto &swept : sweptMeshes) {
+    if(!swept.inWorld)continue;
+    for(uint32_t t=swept.triStart; t<swept.triEnd; ++t) {
+      for(auto &v : sweptTris[t].v)v = &sweptVerts[vertIdx++];
+    }
+  }
+  ticksBVH += get_ticks() - ticksBvhStart;
 
+  for(int s=0; s<steps; ++s)
+  {
+    sphere.center = sphere.center + velocityStep;
+
+    for(auto &swept : sweptMeshes)
+    {
+      auto &mesh = *swept.mesh;
+      auto &meshInst = *swept.instance;
+      auto offset = swept.inWorld ? T3DVec3{{0.0f, 0.0f, 0.0f}} : meshInst.pos;
+      Sphere sphereLocal{
+        .center = sphere.center - offset,
+        .radius = sphere.radius
+      };
+      auto sphereAABB = (sphereLocal * 64.0f).toAABB();
+
+      auto testTriangle = [&](const Triangle &tri) {
         auto collInfo = mesh.vsSphere(sphereLocal, tri);
-        if(collInfo.collCount)
-        {
-          float penLen2 = t3d_vec3_len2(&collInfo.penetration);
-          if(penLen2 < MIN_PENETRATION)continue;
+        if(!collInfo.collCount)return;
+
+        float penLen2 = t3d_vec3_len2(&collInfo.penetration);
+        if(penLen2 < MIN_PENETRATION)return;
 
-          ++res.collCount;
-          res.penetration = res.penetration + collInfo.penetration;
-          res.hitPos = collInfo.hitPos + meshInst->pos;
-          res.normal = collInfo.normal;
+        ++res.collCount;
+        res.penetration = res.penetration + collInfo.penetration;
+        res.hitPos = collInfo.hitPos + offset;
+        res.normal = collInfo.normal;
 
-          //DebugDraw::drawPoint(collInfo.hitPos, RGBA32(0xFF, 0x00, 0x00, 0xFF));
-          sphere.center = sphere.center - collInfo.penetration;
+        //DebugDraw::drawPoint(collInfo.hitPos, RGBA32(0xFF, 0x00, 0x00, 0xFF));
+        sphere.center = sphere.center - collInfo.penetration;
+      };
+
+      if(swept.aabb.containsAABB(sphereAABB)) {
+        for(uint32_t t=swept.triStart; t<swept.triEnd; ++t) {
+          if(sweptTris[t].aabb.vsAABB(sphereAABB))testTriangle(sweptTris[t]);
+        }
+      } else {
+        // pushed outside the swept area, the cached triangles may be incomplete
+        auto ticksBvhStart = get_ticks();
+        bvhTris.clear();
+        auto radiusVec = T3DVec3{{sphere.radius, sphere.radius, sphere.radius}};
+        mesh.bvh->vsAABB(toBVHSpace(meshInst, sphere.center - radiusVec, sphere.center + radiusVec), bvhTris);
+        ticksBVH += get_ticks() - ticksBvhStart;
+
+        T3DVec3 verts[3];
+        for(auto t : bvhTris) {
+          testTriangle(swept.inWorld ? meshInst.getTriangle(mesh, t, verts) : mesh.getTriangle(t));
         }
-      } // BVH res
-    } // meshes
+      }
+    } // (sub-)meshes
   } // steps
 
   ticks += get_ticks() - ticksStart;
   return res;
 }
 
+void Coll::Scene::updateSweep()
+{
+  std::erase_if(sweep, [](const SweepEntry &entry) { return entry.sphere == nullptr; });
+
+  for(auto &entry : sweep) {
+    entry.minX = entry.sphere->center.v[0] - entry.sphere->radius;
+    entry.maxX = entry.sphere->center.v[0] + entry.sphere->radius;
+  }
+
+  // insertion sort, spheres barely move between frames so this is close to linear
+  for(uint32_t i=1; i<sweep.size(); ++i) {
+    auto entry = sweep[i];
+    uint32_t j = i;
+    for(; j > 0 && sweep[j-1].minX > entry.minX; --j) {
+      sweep[j] = sweep[j-1];
+    }
+    sweep[j] = entry;
+  }
+}
+
+void Coll::Scene::collideSpheres(Coll::Sphere &sphere, Coll::Sphere &sphere2)
+{
+  if(!(sphere.mask & sphere2.mask))return;
+  // TODO: source & target mask instead of one mask
+  if(sphere.type == CollType::COIN && sphere2.type == CollType::COIN)return;
+
+  T3DVec3 dir = sphere.center - sphere2.center;
+  auto dist2 = t3d_vec3_len2(dir);
+  float radSum = sphere.radius + sphere2.radius;
+  radSum *= radSum;
+  if(dist2 < radSum)
+  {
+    bool solidA = sphere.interactType & InteractType::SPHERES;
+    bool solidB = sphere2.interactType & InteractType::SPHERES;
+    if(solidA && solidB)
+    {
+      if(dist2 > 0.0001f) {
+        dir /= sqrtf(dist2);
+      } else {
+        dir = T3DVec3{0.0f, 1.0f, 0.0f};
+      }
+      float pen = radSum - dist2;
+
+      bool isFixedA = sphere.interactType & InteractType::FIXED_Y;
+      bool isFixedB = sphere2.interactType & InteractType::FIXED_Y;
+
+      if(isFixedA || isFixedB) {
+        dir.v[1] = 0.0f;
+      }
+
+      // get interp factor based on mass (in this case mass=radius)
+      float interp = sphere.radius / (sphere.radius + sphere2.radius);
+      sphere.center = sphere.center + dir * (pen * (1.0f - interp));
+      sphere2.center = sphere2.center - dir * (pen * interp);
+
+      sphere.hitTriTypes |= TriType::SPHERE;
+      sphere2.hitTriTypes |= TriType::SPHERE;
+    }
+
+    if(sphere.callback)sphere.callback(sphere2);
+    if(sphere2.callback)sphere2.callback(sphere);
+  }
+}
+
 void Coll::Scene::update(float deltaTime)
 {
+  for(auto meshInst : meshes) {
+    if(meshInst->update())++meshVersion;
+  }
+
   for(auto sp : spheres) {
     sp->hitTriTypes = 0;
   }
@@ -135,56 +285,60 @@ void Coll::Scene::update(float deltaTime)
         }
       }
     }
+  }
 
-    // Dynamic Colliders
-    for(uint32_t s2=s+1; s2<spheres.size(); ++s2)
+  // Dynamic Colliders, only spheres overlapping on X are tested against each other.
+  // Callbacks may unregister spheres, which only clears their entry until the next update
+  updateSweep();
+  for(uint32_t s=0; s<sweep.size(); ++s)
+  {
+    float maxX = sweep[s].maxX;
+    for(uint32_t s2=s+1; s2<sweep.size() && sweep[s2].minX <= maxX; ++s2)
     {
-      if(!(sphere->mask & spheres[s2]->mask))continue;
-      // TODO: source & target mask instead of one mask
-      if(sphere->type == CollType::COIN && spheres[s2]->type == CollType::COIN)continue;
-
-      auto sphere2 = spheres[s2];
-      T3DVec3 dir = sphere->center - sphere2->center;
-      auto dist2 = t3d_vec3_len2(dir);
-      float radSum = sphere->radius + sphere2->radius;
-      radSum *= radSum;
-      if(dist2 < radSum)
-      {
-        bool solidA = sphere->interactType & InteractType::SPHERES;
-        bool solidB = sphere2->interactType & InteractType::SPHERES;
-        if(solidA && solidB)
-        {
-          if(dist2 > 0.0001f) {
-            dir /= sqrtf(dist2);
-          } else {
-            dir = T3DVec3{0.0f, 1.0f, 0.0f};
-          }
-          float pen = radSum - dist2;
-
-          bool isFixedA = sphere->interactType & InteractType::FIXED_Y;
-          bool isFixedB = sphere2->interactType & InteractType::FIXED_Y;
+      if(!sweep[s].sphere)break;
+      if(!sweep[s2].sphere)continue;
+      ++pairCount;
+      collideSpheres(*sweep[s].sphere, *sweep[s2].sphere);
+    }
+  }
+}
 
-          if(isFixedA || isFixedB) {
-            dir.v[1] = 0.0f;
-          }
+void Coll::Scene::fillFloorCache(Coll::FloorCache &cache, const T3DVec3 &pos)
+{
+  cache.count = 0;
+  cache.meshVersion = meshVersion;
+  cache.overflow = false;
+  cache.min[0] = pos.v[0] - FloorCache::RANGE;
+  cache.min[1] = pos.v[2] - FloorCache::RANGE;
+  cache.max[0] = pos.v[0] + FloorCache::RANGE;
+  cache.max[1] = pos.v[2] + FloorCache::RANGE;
 
-          // get interp factor based on mass (in this case mass=radius)
-          float interp = sphere->radius / (sphere->radius + sphere2->radius);
-          sphere->center = sphere->center + dir * (pen * (1.0f - interp));
-          sphere2->center = sphere2->center - dir * (pen * interp);
+  for(auto meshInst : meshes)
+  {
+    // the floor ray ignores height, so only limit the area in XZ
+    auto area = toBVHSpace(*meshInst,
+      T3DVec3{{cache.min[0], -MAX_HEIGHT, cache.min[1]}},
+      T3DVec3{{cache.max[0], MAX_HEIGHT, cache.max[1]}}
+    );
 
-          sphere->hitTriTypes |= TriType::SPHERE;
-          sphere2->hitTriTypes |= TriType::SPHERE;
+    for(auto subMesh = meshInst->mesh; subMesh; subMesh = subMesh->next)
+    {
+      bvhTris.clear();
+      subMesh->bvh->vsAABB(area, bvhTris);
+      for(auto t : bvhTris) {
+        if(!isFloorTri(*meshInst, *subMesh, t))continue;
+        if(cache.count == FloorCache::MAX_TRIS) {
+          cache.count = 0;
+          cache.overflow = true;
+          return;
         }
-
-        if(sphere->callback)sphere->callback(*sphere2);
-        if(sphere2->callback)sphere2->callback(*sphere);
+        cache.tris[cache.count++] = {subMesh, meshInst, t};
       }
     }
   }
 }
 
-Coll::CollInfo Coll::Scene::raycastFloor(const T3DVec3 &pos) {
+Coll::CollInfo Coll::Scene::raycastFloor(const T3DVec3 &pos, FloorCache *cache) {
   ++raycastCount;
   Coll::CollInfo res{
     .hitPos = T3DVec3{0.0f, 0.0f, 0.0f},
@@ -193,51 +347,85 @@ Coll::CollInfo Coll::Scene::raycastFloor(const T3DVec3 &pos) {
     .collCount = 0,
   };
 
-  for(auto meshInst : meshes)
-  {
-    auto &mesh = *meshInst->mesh;
-    auto posLocal = pos - meshInst->pos;
-    Coll::IVec3 posInt = {
-      .v = {
-        (int16_t)(posLocal.v[0] * 64.0f),
-        (int16_t)(posLocal.v[1] * 64.0f),
-        (int16_t)(posLocal.v[2] * 64.0f)
-      }
-    };
+  // keep the highest hit across all meshes (in world space)
+  float highestFloor = -99999.0f;
+  auto testFloor = [&](const MeshInstance &meshInst, const Mesh &mesh, uint32_t t) {
+    // the ray stays vertical only in world space, so rotated/scaled instances test world space triangles
+    T3DVec3 verts[3];
+    auto offset = meshInst.isTransformed ? T3DVec3{{0.0f, 0.0f, 0.0f}} : meshInst.pos;
+    Triangle tri = meshInst.isTransformed ? meshInst.getTriangle(mesh, t, verts) : mesh.getTriangle(t);
+
+    auto collInfo = mesh.vsFloorRay(pos - offset, tri);
+    if(collInfo.collCount && (collInfo.hitPos.v[1] + offset.v[1]) > highestFloor)
+    {
+      res.collCount = 1;
+      res.hitPos = collInfo.hitPos + offset;
+      res.normal = collInfo.normal;
+      highestFloor = res.hitPos.v[1];
+    }
+  };
+
+  bool useCache = false;
+  if(cache) {
+    // every floor triangle containing a point of the area in XZ is in the cache,
+    // so moving around in it needs no BVH query at all
+    bool inArea = cache->meshVersion == meshVersion
+      && pos.v[0] >= cache->min[0] && pos.v[0] <= cache->max[0]
+      && pos.v[2] >= cache->min[1] && pos.v[2] <= cache->max[1];
 
-    Coll::BVHResult bvhRes{};
-    mesh.bvh->raycastFloor(posInt, bvhRes);
+    if(!inArea) {
+      auto ticksBvhStart = get_ticks();
+      fillFloorCache(*cache, pos);
+      ticksBVH += get_ticks() - ticksBvhStart;
+    } else if(!cache->overflow) {
+      ++raycastCacheHits;
+    }
+    useCache = !cache->overflow;
+  }
 
-    float highestFloor = -99999.0f;
-    for(int b=0; b<bvhRes.count; ++b)
+  if(useCache) {
+    for(uint32_t i=0; i<cache->count; ++i) {
+      auto &entry = cache->tris[i];
+      testFloor(*entry.instance, *entry.mesh, entry.tri);
+    }
+  } else {
+    for(auto meshInst : meshes)
     {
-    //for(uint32_t b=0; b<mesh.triCount; ++b) {
-      uint32_t t = bvhRes.triIndex[b];
-      //uint32_t t = b;
-      if(!isFloor(mesh.normals[t]))continue;
-
-      int idxA = mesh.indices[t*3];
-      int idxB = mesh.indices[t*3+1];
-      int idxC = mesh.indices[t*3+2];
-      auto &norm = mesh.normals[t];
-
-      Triangle tri{
-        .normal = {{
-         (float)norm.v[0] / 32767.0f,
-         (float)norm.v[1] / 32767.0f,
-         (float)norm.v[2] / 32767.0f
-        }},
-        .v = {&mesh.verts[idxA], &mesh.verts[idxB], &mesh.verts[idxC]}
-      };
+      if(meshInst->isTransformed) {
+        auto line = toBVHSpace(*meshInst, T3DVec3{{pos.v[0], -MAX_HEIGHT, pos.v[2]}}, T3DVec3{{pos.v[0], MAX_HEIGHT, pos.v[2]}});
+        for(auto subMesh = meshInst->mesh; subMesh; subMesh = subMesh->next)
+        {
+          bvhTris.clear();
+          subMesh->bvh->vsAABB(line, bvhTris);
+          for(auto t : bvhTris) {
+            if(isFloorTri(*meshInst, *subMesh, t))testFloor(*meshInst, *subMesh, t);
+          }
+        }
+        continue;
+      }
 
-      auto collInfo = mesh.vsFloorRay(posLocal, tri);
-      if(collInfo.collCount && collInfo.hitPos.v[1] > highestFloor)
+      for(auto subMesh = meshInst->mesh; subMesh; subMesh = subMesh->next)
       {
-        res.collCount = 1;
-        res.hitPos = collInfo.hitPos + meshInst->pos;
-        res.normal = collInfo.normal;
-        highestFloor = collInfo.hitPos.v[1];
-      }
+        auto &mesh = *subMesh;
+        auto posLocal = pos - meshInst->pos;
+        Coll::IVec3 posInt = {
+          .v = {
+            (int16_t)(posLocal.v[0] * 64.0f),
+            (int16_t)(posLocal.v[1] * 64.0f),
+            (int16_t)(posLocal.v[2] * 64.0f)
+          }
+        };
+
+        Coll::BVHResult bvhRes{};
+        mesh.bvh->raycastFloor(posInt, bvhRes);
+
+        for(int b=0; b<bvhRes.count; ++b)
+        {
+          uint32_t t = bvhRes.triIndex[b];
+          if(!mesh.isFloor(t))continue;
+          testFloor(*meshInst, mesh, t);
+        }
+      } // sub-meshes
     }
   }
 
@@ -260,23 +448,25 @@ void Coll::Scene::debugDraw(bool showMesh, bool showSpheres)
 {
   if(showMesh) {
     for(const auto &meshInst : meshes) {
-      auto &mesh = *meshInst->mesh;
-      for(uint32_t t=0; t<mesh.triCount; ++t) {
-        int idxA = mesh.indices[t*3];
-        int idxB = mesh.indices[t*3+1];
-        int idxC = mesh.indices[t*3+2];
-        auto v0 = (mesh.verts[idxA] + meshInst->pos) * 16.0f;
-        auto v1 = (mesh.verts[idxB] + meshInst->pos) * 16.0f;
-        auto v2 = (mesh.verts[idxC] + meshInst->pos) * 16.0f;
-
-        if(mesh.normals[t].v[2] < 0)continue;
-        auto color = isFloor(mesh.normals[t])
-          ? color_t{0x00, 0xAA, 0xEE, 0xFF}
-          : color_t{0x00, 0xEE, 0x42, 0xFF};
-
-        Debug::drawLine(v0, v1, color);
-        Debug::drawLine(v1, v2, color);
-        Debug::drawLine(v2, v0, color);
+      for(auto subMesh = meshInst->mesh; subMesh; subMesh = subMesh->next) {
+        auto &mesh = *subMesh;
+        for(uint32_t t=0; t<mesh.triCount; ++t) {
+          int idxA = mesh.indices[t*3];
+          int idxB = mesh.indices[t*3+1];
+          int idxC = mesh.indices[t*3+2];
+          auto v0 = meshInst->toWorld(mesh.verts[idxA]) * 16.0f;
+          auto v1 = meshInst->toWorld(mesh.verts[idxB]) * 16.0f;
+          auto v2 = meshInst->toWorld(mesh.verts[idxC]) * 16.0f;
+
+          if(mesh.normals[t].v[2] < 0)continue;
+          auto color = mesh.isFloor(t)
+            ? color_t{0x00, 0xAA, 0xEE, 0xFF}
+            : color_t{0x00, 0xEE, 0x42, 0xFF};
+
+          Debug::drawLine(v0, v1, color);
+          Debug::drawLine(v1, v2, color);
+          Debug::drawLine(v2, v0, color);
+        }
       }
     }
   }
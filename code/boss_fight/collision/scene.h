@@ -11,32 +11,93 @@
 
 namespace Coll
  {
+  /**
+   * Floor triangles around the last raycastFloor() position of one caller.
+   * As long as the next ray stays inside 'min'/'max' (XZ), only these get tested instead of the BVH.
+   */
+  struct FloorCache {
+    constexpr static uint32_t MAX_TRIS = 16;
+    constexpr static float RANGE = 0.5f; // half size of the cached area
+
+    struct Entry {
+      const Mesh *mesh{};
+      const MeshInstance *instance{};
+      uint16_t tri{};
+    };
+
+    Entry tris[MAX_TRIS]{};
+    uint32_t count{0};
+    uint32_t meshVersion{0}; // scene mesh set it was filled for, 0 if empty
+    bool overflow{false}; // area has more than MAX_TRIS floors, rays in it use the BVH
+    float min[2]{}; // XZ, world space
+    float max[2]{};
+  };
+
   class Scene {
     private:
       constexpr static uint32_t VOID_SPHERE_COUNT = 2;
 
+      // broadphase entry, spheres are kept sorted by 'minX' across frames (sort-and-sweep)
+      struct SweepEntry {
+        float minX{};
+        float maxX{};
+        Sphere *sphere{}; // nullptr if unregistered, removed on the next update
+      };
+
+      // candidate triangles of a swept sphere query, grouped by (sub-)mesh
+      struct SweptMesh {
+        const Mesh *mesh{};
+        const MeshInstance *instance{};
+        AABB aabb{}; // area the triangles were collected for
+        uint32_t triStart{};
+        uint32_t triEnd{};
+        bool inWorld{}; // triangles are in world instead of mesh space (rotated/scaled instance)
+      };
+
       std::set<MeshInstance*> meshes{};
+      uint32_t meshVersion{1}; // changes with 'meshes', invalidates floor caches
       std::vector<Sphere*> spheres{};
+      std::vector<SweepEntry> sweep{};
       Sphere voidSpheres[VOID_SPHERE_COUNT]{};
 
+      // reused across queries to avoid allocations
+      std::vector<SweptMesh> sweptMeshes{};
+      std::vector<Triangle> sweptTris{};
+      std::vector<T3DVec3> sweptVerts{}; // of triangles in world space
+      std::vector<uint16_t> bvhTris{};
+
+      void updateSweep();
+      void collideSpheres(Sphere &sphere, Sphere &sphere2);
+      void fillFloorCache(FloorCache &cache, const T3DVec3 &pos);
+
     public:
       uint64_t ticks{0};
       uint64_t ticksBVH{0};
       uint64_t raycastCount{0};
+      uint64_t raycastCacheHits{0}; // rays answered by a FloorCache without a BVH query
+      uint32_t pairCount{0}; // sphere pairs that passed the broadphase
 
       void registerMesh(MeshInstance *mesh) {
+        mesh->update();
         meshes.insert(mesh);
+        ++meshVersion;
       }
 
       void unregisterMesh(MeshInstance *mesh) {
         meshes.erase(mesh);
+        ++meshVersion;
       }
 
       void registerSphere(Sphere *sphere) {
         spheres.push_back(sphere);
+        sweep.push_back({0.0f, 0.0f, sphere});
       }
 
       void unregisterSphere(Sphere *sphere) {
+        // may happen in a collision callback, so only mark it here
+        for(auto &entry : sweep) {
+          if(entry.sphere == sphere)entry.sphere = nullptr;
+        }
         for(auto it = spheres.begin(); it != spheres.end(); ++it) {
           if(*it == sphere)return (void)spheres.erase(it);
         }
@@ -50,7 +111,11 @@ namespace Coll
 
       CollInfo vsSphere(Sphere &sphere, const T3DVec3 &velocity, float deltaTime);
 
-      CollInfo raycastFloor(const T3DVec3 &pos);
+      /**
+       * Finds the highest floor below 'pos'.
+       * Callers that ray from (almost) the same spot each frame should pass their own cache.
+       */
+      CollInfo raycastFloor(const T3DVec3 &pos, FloorCache *cache = nullptr);
 
       [[nodiscard]] const std::vector<Sphere*> &getSpheres() const {
         return spheres;
@@ -18,6 +18,9 @@ namespace Coll
     constexpr uint8_t SPHERE = 1 << 3;
   }
 
+  // triangles with a normal steeper than this count as floor
+  constexpr float FLOOR_ANGLE = 0.7f;
+
   namespace InteractType {
     constexpr uint8_t TRI_MESH = 1 << 0;
     constexpr uint8_t SPHERES  = 1 << 1;
@@ -45,6 +48,7 @@ namespace Coll
     IVec3 max{};
 
     bool vsAABB(const AABB &other) const;
+    bool containsAABB(const AABB &other) const;
     bool vs2DPointY(const IVec3 &pos) const;
   };
   static_assert(sizeof(AABB) == (6 * sizeof(int16_t)));
@@ -85,11 +89,23 @@ namespace Coll
     int collCount{};
   };
 
+  // optional precomputed data per triangle (gltf_to_coll --tri-data)
+  struct TriData
+  {
+    T3DVec3 normal{};
+    float planeDist{}; // dot(normal, v[0])
+    float baryCoeff[3]{}; // barycentric terms pre-divided by their denominator, all 0 if degenerate
+    float edgeInvLen2[3]{}; // edges v0->v1, v1->v2, v2->v0
+    uint32_t type{}; // TriType::FLOOR or TriType::WALL
+  };
+  static_assert(sizeof(TriData) == 44);
+
   struct Triangle
   {
     T3DVec3 normal{};
     T3DVec3* v[3]{};
     AABB aabb{};
+    const TriData* data{};
   };
 
   struct Triangle2D {
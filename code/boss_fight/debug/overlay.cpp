@@ -103,11 +103,11 @@ void Debug::Overlay::draw(Scene &scene, int triCount, float deltaTime) {
   posX = Debug::printf(posX, posY, "%.2f", (double)TICKS_TO_US(collScene.ticksBVH) / 1000.0) + 8;
   rdpq_set_prim_color(COLOR_COLL);
   posX = Debug::printf(posX, posY, "%.2f", (double)TICKS_TO_US(collScene.ticks - collScene.ticksBVH) / 1000.0) + 2;
-  posX = Debug::printf(posX, posY, ":%d", collScene.raycastCount) + 8;
+  posX = Debug::printf(posX, posY, ":%d/%d:%d", collScene.raycastCacheHits, collScene.raycastCount, collScene.pairCount) + 8;
   rdpq_set_prim_color(COLOR_ACTOR_UPDATE);
   posX = Debug::printf(posX, posY, "%.2f", (double)TICKS_TO_US(scene.ticksActorUpdate) / 1000.0) + 8;
   rdpq_set_prim_color(COLOR_CULL);
-  Debug::printf(posX, posY + 9, "%.2f", (double)TICKS_TO_US(scene.ticksCull) / 1000.0);
+  Debug::printf(posX, posY + 9, "%.2f:%d", (double)TICKS_TO_US(scene.ticksCull) / 1000.0, scene.getMapModel().recordCount);
   posX = Debug::printf(posX, posY, "%.2f", (double)TICKS_TO_US(scene.getAudio().ticks) / 1000.0) + 8;
 
   rdpq_set_prim_color({0xFF,0xFF,0xFF, 0xFF});
@@ -5,32 +5,141 @@
 #include "../main.h"
 #include "culledModel.h"
 #include <array>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
 
 namespace {
   constexpr float MAP_SCALE = 0.25f;
 
   constexpr uint32_t LAYER_COUNT = 6;
-  constexpr uint32_t LAYER_OBJ_COUNT = 16;
+  constexpr uint32_t LAYER_DEPTH = LAYER_COUNT - 1; // only layer with depth, draw order doesn't matter here
+
+  // The camera only ever moves along X, so the visible objects only depend on its X position.
+  // Each segment of that axis stores the objects visible from anywhere inside it (PVS).
+  constexpr float SEGMENT_SIZE = 32.0f;
+
+  // Each layer is recorded into its own block, which only calls the per-object blocks and sets materials.
+  // A few blocks per layer are kept around, so only layers whose objects changed get recorded again.
+  constexpr uint32_t LAYER_BLOCK_CACHE_SIZE = 4;
+  constexpr uint32_t FRAMES_IN_FLIGHT = 3; // a block may still be used by the RSP for this many frames
+  static_assert(LAYER_BLOCK_CACHE_SIZE > FRAMES_IN_FLIGHT, "LRU block must always be safe to free");
+
+  struct Segment {
+    std::vector<T3DObject*> objects{};
+  };
+
+  struct LayerBlock {
+    rspq_block_t* block{};
+    uint64_t hash{}; // of the objects it draws
+    uint32_t lastUsedFrame{};
+  };
 
   float scrollOffset = 0.0f;
 
-  std::array<std::array<T3DObject*, LAYER_OBJ_COUNT>, LAYER_COUNT> layerObj;
-  std::array<uint8_t, LAYER_COUNT> layerCount;
+  std::array<std::vector<T3DObject*>, LAYER_COUNT> layerObj{}; // recorded into the layer block
+  std::array<std::vector<T3DObject*>, LAYER_COUNT> layerObjLive{}; // animated materials, drawn each frame
+  std::array<std::array<LayerBlock, LAYER_BLOCK_CACHE_SIZE>, LAYER_COUNT> layerBlocks{};
+  std::array<LayerBlock*, LAYER_COUNT> layerBlockCurr{}; // nullptr if it needs to be recorded
+  std::array<uint64_t, LAYER_COUNT> layerHash{};
+
+  std::unordered_map<int32_t, Segment> segments{};
+  int32_t currSegment = INT32_MIN;
+  uint32_t frame = 0;
+  float lastCamX = 0.0f;
+  bool hasLastCam = false;
+
+  bool isLiveMaterial(const T3DObject *obj) {
+    return obj->material->name[0] == '#';
+  }
+
+  /**
+   * Objects visible from anywhere in the given X-range, using the current frustum from 'frustumCamX'.
+   * All planes get moved to the center of the range and then pushed out by half its size (along X),
+   * which results in a frustum containing all the ones inside the range.
+   */
+  void queryVisible(T3DModel *model, Segment &seg, float centerX, float halfSize, float frustumCamX)
+  {
+    auto frustum = t3d_viewport_get()->viewFrustum;
+    for(auto &plane : frustum.planes) {
+      plane.v[3] += fabsf(plane.v[0]) * halfSize - plane.v[0] * (centerX - frustumCamX);
+    }
+    t3d_frustum_scale(&frustum, MAP_SCALE);
+    t3d_model_bvh_query_frustum(t3d_model_bvh_get(model), &frustum);
+
+    seg.objects.clear();
+    auto it = t3d_model_iter_create(model, T3D_CHUNK_TYPE_OBJECT);
+    while(t3d_model_iter_next(&it)) {
+      if(!it.object->isVisible)continue;
+      it.object->isVisible = false;
+      seg.objects.push_back(it.object);
+    }
+  }
 
-  std::array<rspq_block_t*, 4> currBlock{};
-  uint32_t currBlockIdx = 0;
-  uint64_t lastHash = 0;
-  bool needsUpdate = false;
-  bool needsLiveMaterial = false;
+  LayerBlock* findLayerBlock(uint32_t layer, uint64_t hash)
+  {
+    for(auto &entry : layerBlocks[layer]) {
+      if(entry.block && entry.hash == hash)return &entry;
+    }
+    return nullptr;
+  }
+
+  // least recently used entry of a layer, its old block is freed
+  LayerBlock* allocLayerBlock(uint32_t layer, uint64_t hash)
+  {
+    LayerBlock *res = &layerBlocks[layer][0];
+    for(auto &entry : layerBlocks[layer]) {
+      if(!entry.block) {
+        res = &entry;
+        break;
+      }
+      if(entry.lastUsedFrame < res->lastUsedFrame)res = &entry;
+    }
+    if(res->block)rspq_block_free(res->block);
+    *res = {nullptr, hash, frame};
+    return res;
+  }
+
+  void setLayers(const Segment &seg)
+  {
+    for(uint32_t i = 0; i < LAYER_COUNT; ++i) {
+      layerObj[i].clear();
+      layerObjLive[i].clear();
+    }
+    for(auto obj : seg.objects) {
+      auto &layer = isLiveMaterial(obj) ? layerObjLive : layerObj;
+      layer[obj->_padding[0]].push_back(obj);
+    }
+
+    // sort by material to skip redundant state changes, other layers rely on their order
+    std::stable_sort(layerObj[LAYER_DEPTH].begin(), layerObj[LAYER_DEPTH].end(), [](auto a, auto b) {
+      return a->material < b->material;
+    });
+
+    for(uint32_t i = 0; i < LAYER_COUNT; ++i) {
+      uint64_t hash = 0;
+      for(auto obj : layerObj[i]) {
+        hash ^= ((uint64_t)(void*)(obj)) | ((uint64_t)obj->triCount << 32);
+        hash = std::rotl(hash, 10);
+      }
+      if(layerBlockCurr[i] && layerHash[i] == hash)continue;
+      layerHash[i] = hash;
+      layerBlockCurr[i] = findLayerBlock(i, hash);
+    }
+  }
 }
 
 CulledModel::CulledModel(const char *modelPath)
 {
-  layerObj.fill({});
-  layerCount.fill(0);
-  currBlock.fill(nullptr);
-  currBlockIdx = 0;
-  needsUpdate = false;
+  for(auto &layer : layerObj)layer.clear();
+  for(auto &layer : layerObjLive)layer.clear();
+  for(auto &layer : layerBlocks)layer.fill({});
+  layerBlockCurr.fill(nullptr);
+  layerHash.fill(0);
+  segments.clear();
+  currSegment = INT32_MIN;
+  frame = 0;
+  hasLastCam = false;
 
   model = t3d_model_load(modelPath);
   auto it = t3d_model_iter_create(model, T3D_CHUNK_TYPE_OBJECT);
@@ -66,6 +175,11 @@ CulledModel::CulledModel(const char *modelPath)
       }
     }
     it.object->_padding[0] = layerId; // @TODO: add generic user-defined IDs to t3d struct?
+
+    // geometry never changes, layers only call this block
+    rspq_block_begin();
+      t3d_model_draw_object(it.object, nullptr);
+    it.object->userBlock = rspq_block_end();
   }
 
   mapMatFP = (T3DMat4FP*)malloc_uncached(sizeof(T3DMat4FP));
@@ -77,47 +191,50 @@ CulledModel::CulledModel(const char *modelPath)
 }
 
 CulledModel::~CulledModel() {
-  t3d_model_free(model);
-  free_uncached(mapMatFP);
-
   rspq_wait();
-  for(auto &block : currBlock) {
-    if(block)rspq_block_free(block);
+  for(auto &layer : layerBlocks) {
+    for(auto &entry : layer) {
+      if(entry.block)rspq_block_free(entry.block);
+    }
   }
+  segments.clear();
+
+  t3d_model_free(model); // also frees the per-object blocks
+  free_uncached(mapMatFP);
 }
 
 void CulledModel::update(const T3DVec3 &camPos) {
-  auto bvh = t3d_model_bvh_get(model);
-  auto vp = t3d_viewport_get();
-  auto frustomLocal = vp->viewFrustum;
-  t3d_frustum_scale(&frustomLocal, MAP_SCALE);
-  t3d_model_bvh_query_frustum(bvh, &frustomLocal);
-
-  // put all visible objects into layers, and set counters...
-
-  uint64_t newHash = 0;
-  layerCount.fill(0);
-  auto it = t3d_model_iter_create(model, T3D_CHUNK_TYPE_OBJECT);
-  while(t3d_model_iter_next(&it)) {
-    if(it.object->isVisible) {
-      uint8_t layerId = it.object->_padding[0];
-      layerObj[layerId][layerCount[layerId]++] = it.object;
-      it.object->isVisible = false;
-
-      if(it.object->material->name[0] == '#') {
-        needsLiveMaterial = true;
-      }
+  ++frame;
+  scrollOffset = camPos.x*2;
+  scrollOffset = fm_fmodf(scrollOffset, 128.0f);
 
-      newHash ^= ((uint64_t)(void*)(it.object)) | ((uint64_t)it.object->triCount << 32);
-      newHash = std::rotl(newHash, 10);
-    }
+  // the frustum is only updated when the viewport gets attached, so it lags one frame behind 'camPos'
+  if(!hasLastCam) {
+    // no frustum yet, draw what is visible now without keeping it as a segment
+    Segment seg{};
+    queryVisible(model, seg, camPos.x, 0.0f, camPos.x);
+    setLayers(seg);
+    currSegment = INT32_MIN;
+    hasLastCam = true;
+    lastCamX = camPos.x;
+    return;
   }
 
-  needsUpdate = (newHash != lastHash) || needsLiveMaterial;
-  lastHash = newHash;
+  int32_t segIdx = (int32_t)floorf(camPos.x / SEGMENT_SIZE);
+  if(segIdx != currSegment)
+  {
+    auto segIt = segments.find(segIdx);
+    if(segIt == segments.end()) {
+      // new segment, the frustum may belong to either this or the last position, so cover the distance too
+      float halfSize = SEGMENT_SIZE * 0.5f + fabsf(camPos.x - lastCamX);
+      segIt = segments.emplace(segIdx, Segment{}).first;
+      queryVisible(model, segIt->second, (segIdx + 0.5f) * SEGMENT_SIZE, halfSize, lastCamX);
+    }
 
-  scrollOffset = camPos.x*2;
-  scrollOffset = fm_fmodf(scrollOffset, 128.0f);
+    setLayers(segIt->second);
+    currSegment = segIdx;
+  }
+  lastCamX = camPos.x;
 }
 
 uint32_t CulledModel::draw(T3DModelState &t3dState) {
@@ -125,46 +242,47 @@ uint32_t CulledModel::draw(T3DModelState &t3dState) {
 
   auto ticks = get_ticks();
 
-  if(needsUpdate)
-  {
-    if(!needsLiveMaterial) {
-      currBlockIdx = (currBlockIdx + 1) & 3;
-      if(currBlock[currBlockIdx])rspq_block_free(currBlock[currBlockIdx]);
-      rspq_block_begin();
-    }
+  t3d_matrix_set(mapMatFP, true);
 
-    t3d_matrix_set(mapMatFP, true);
+  // draw layers in order, each one is the recorded block followed by animated materials
+  //debugf("==== Draw Layer:\n");
+  for(uint32_t i = 0; i < LAYER_COUNT; ++i) {
+    //debugf("  - Layer %ld\n", i);
+    if(!layerObj[i].empty())
+    {
+      if(!layerBlockCurr[i]) {
+        layerBlockCurr[i] = allocLayerBlock(i, layerHash[i]);
+        ++recordCount;
 
-    // ...then draw in one go in order
-    //debugf("==== Draw Layer:\n");
-    for(uint32_t i = 0; i < LAYER_COUNT; ++i) {
-      //debugf("  - Layer %ld\n", i);
-      for(uint32_t j = 0; j < layerCount[i]; ++j) {
-        auto obj = layerObj[i][j];
-        //debugf("    - Obj %s\n", obj->name);
-        if(obj->material->name[0] == '#') {
-          obj->material->textureB.s.low = scrollOffset;
-          obj->material->textureB.t.low = scrollOffset;
+        // recorded blocks can't make any assumption about the state before them
+        auto layerState = t3d_model_state_create();
+        rspq_block_begin();
+        for(auto obj : layerObj[i]) {
+          //debugf("    - Obj %s\n", obj->name);
+          t3d_model_draw_material(obj->material, &layerState);
+          rspq_block_run(obj->userBlock);
         }
-        t3d_model_draw_material(obj->material, &t3dState);
-        t3d_model_draw_object(obj, nullptr);
-        triCount += obj->triCount;
+        layerBlockCurr[i]->block = rspq_block_end();
       }
-    }
 
-    t3d_state_set_vertex_fx(T3D_VERTEX_FX_NONE, 0, 0);
+      rspq_block_run(layerBlockCurr[i]->block);
+      layerBlockCurr[i]->lastUsedFrame = frame;
+      t3dState = t3d_model_state_create();
+    }
 
-    if(!needsLiveMaterial) {
-      currBlock[currBlockIdx] = rspq_block_end();
+    for(auto obj : layerObjLive[i]) {
+      obj->material->textureB.s.low = scrollOffset;
+      obj->material->textureB.t.low = scrollOffset;
+      t3d_model_draw_material(obj->material, &t3dState);
+      rspq_block_run(obj->userBlock);
     }
-  }
 
-  if(!needsLiveMaterial) {
-    rspq_block_run(currBlock[currBlockIdx]);
+    for(auto obj : layerObj[i])triCount += obj->triCount;
+    for(auto obj : layerObjLive[i])triCount += obj->triCount;
   }
 
-  needsUpdate = false;
-  needsLiveMaterial = false;
+  t3d_state_set_vertex_fx(T3D_VERTEX_FX_NONE, 0, 0);
+
   ticks = get_ticks() - ticks;
   //debugf(" - Draw time: %lld\n", TICKS_TO_US(ticks));
   return triCount;
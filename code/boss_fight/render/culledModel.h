@@ -13,6 +13,8 @@ class CulledModel
     T3DMat4FP* mapMatFP{};
 
   public:
+    uint32_t recordCount{0}; // layer blocks recorded in total, to see how often it happens
+
     CulledModel(const char *modelPath);
     ~CulledModel();
 
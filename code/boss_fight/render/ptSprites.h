@@ -6,15 +6,12 @@
 #include <t3d/t3d.h>
 #include <t3d/tpx.h>
 
-#include "ptSystem.h"
+#include "ptStore.h"
 
 class PTSprites
 {
   private:
-    PTSystem systems[4]{
-      PTSystem(128), PTSystem(128),
-      PTSystem(128), PTSystem(128),
-    };
+    PTStore store;
 
     sprite_t *sprite{};
     rspq_block_t *setupDPL{};
@@ -23,7 +20,6 @@ class PTSprites
     uint16_t mirrorPt = 32;
     color_t color;
 
-    PTSystem* getBySection(float sectionX);
   public:
     explicit PTSprites(const char* spritePath, bool isRotating = false);
     ~PTSprites();
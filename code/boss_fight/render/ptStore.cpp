@@ -0,0 +1,148 @@
+/**
+* @copyright 2024 - Max Bebök
+* @license MIT
+*/
+#include "ptStore.h"
+
+namespace {
+  // particles are drawn as screen-space quads around their position, keep sections visible a bit longer
+  constexpr float CULL_MARGIN = 16.0f;
+}
+
+PTStore::PTStore(float offsetY, float scaleY)
+  : offsetY{offsetY}, scaleY{scaleY}
+{
+}
+
+PTStore::~PTStore() {
+  for(auto system : systems)delete system;
+}
+
+void PTStore::add(const T3DVec3 &pos, float ptSize, color_t col)
+{
+  posX.push_back(pos.x);
+  posY.push_back(pos.y);
+  posZ.push_back(pos.z);
+  size.push_back(ptSize);
+  color.push_back(col);
+}
+
+void PTStore::remove(uint32_t index)
+{
+  // order doesn't matter, move the last one into the gap
+  uint32_t last = count() - 1;
+  posX[index] = posX[last]; posX.pop_back();
+  posY[index] = posY[last]; posY.pop_back();
+  posZ[index] = posZ[last]; posZ.pop_back();
+  size[index] = size[last]; size.pop_back();
+  color[index] = color[last]; color.pop_back();
+}
+
+void PTStore::clear()
+{
+  posX.clear();
+  posY.clear();
+  posZ.clear();
+  size.clear();
+  color.clear();
+}
+
+PTSystem* PTStore::getSystem(float sectionX)
+{
+  if(systemCount == systems.size()) {
+    systems.push_back(new PTSystem(SYSTEM_SIZE));
+    systems.back()->pos = {-999,0,0}; // forces matrix creation
+  }
+
+  auto sys = systems[systemCount++];
+  sys->count = 0;
+  if(sys->pos.x != sectionX) {
+    sys->pos = {sectionX, offsetY, 0};
+    t3d_mat4fp_from_srt_euler(sys->mat, {1.0f, 1.0f / scaleY, 1.0f}, {0,0,0}, sys->pos);
+  }
+  return sys;
+}
+
+void PTStore::pack()
+{
+  systemCount = 0;
+  uint32_t ptCount = count();
+  if(ptCount == 0)return;
+
+  // bin by X-section (counting sort)...
+  partSection.resize(ptCount);
+  int32_t sectionMin = INT32_MAX;
+  int32_t sectionMax = INT32_MIN;
+  for(uint32_t i=0; i<ptCount; ++i) {
+    int32_t section = (int32_t)fm_floorf((posX[i] + 127.0f) / SECTION_SIZE);
+    partSection[i] = section;
+    sectionMin = section < sectionMin ? section : sectionMin;
+    sectionMax = section > sectionMax ? section : sectionMax;
+  }
+
+  sectionCount.assign(sectionMax - sectionMin + 1, 0);
+  for(uint32_t i=0; i<ptCount; ++i) {
+    ++sectionCount[partSection[i] - sectionMin];
+  }
+
+  // ...cull sections against the camera, and mark culled ones as empty...
+  auto &frustum = t3d_viewport_get()->viewFrustum;
+  float rangeY = 127.0f / scaleY + CULL_MARGIN;
+  float rangeXZ = 128.0f + CULL_MARGIN;
+  for(uint32_t s=0; s<sectionCount.size(); ++s) {
+    if(sectionCount[s] == 0)continue;
+    float sectionX = (float)(sectionMin + (int32_t)s) * SECTION_SIZE;
+    T3DVec3 aabbMin{{sectionX - rangeXZ, offsetY - rangeY, -rangeXZ}};
+    T3DVec3 aabbMax{{sectionX + rangeXZ, offsetY + rangeY,  rangeXZ}};
+    if(!t3d_frustum_vs_aabb(&frustum, &aabbMin, &aabbMax))sectionCount[s] = 0;
+  }
+
+  // ...turn the counts into offsets, and scatter the indices of visible particles to their section...
+  sectionOffset.resize(sectionCount.size() + 1);
+  sectionOffset[0] = 0;
+  for(uint32_t s=0; s<sectionCount.size(); ++s) {
+    sectionOffset[s+1] = sectionOffset[s] + sectionCount[s];
+    sectionCount[s] = sectionOffset[s]; // now the write position
+  }
+
+  partOrder.resize(sectionOffset.back());
+  for(uint32_t i=0; i<ptCount; ++i) {
+    uint32_t s = partSection[i] - sectionMin;
+    if(sectionOffset[s] == sectionOffset[s+1])continue;
+    partOrder[sectionCount[s]++] = i;
+  }
+
+  // ...then pack the visible ones section by section, each into as many buffers as it needs
+  for(uint32_t s=0; s<sectionCount.size(); ++s) {
+    if(sectionOffset[s] == sectionOffset[s+1])continue;
+    float sectionX = (float)(sectionMin + (int32_t)s) * SECTION_SIZE;
+
+    PTSystem *sys = nullptr;
+    for(uint32_t o=sectionOffset[s]; o<sectionOffset[s+1]; ++o) {
+      uint32_t i = partOrder[o];
+      if(!sys || sys->isFull())sys = getSystem(sectionX);
+
+      auto p = tpx_buffer_get_pos(sys->particles, sys->count);
+      p[0] = (int8_t)(posX[i] - sectionX);
+      p[1] = (int8_t)((posY[i] - offsetY) * scaleY);
+      p[2] = (int8_t)posZ[i];
+
+      *tpx_buffer_get_size(sys->particles, sys->count) = (int8_t)size[i];
+      *(color_t*)tpx_buffer_get_rgba(sys->particles, sys->count) = color[i];
+      ++sys->count;
+    }
+
+    // tpx draws pairs of particles, hide a possible odd one
+    if(sys->count % 2 != 0) {
+      *tpx_buffer_get_size(sys->particles, sys->count) = 0;
+      ++sys->count;
+    }
+  }
+}
+
+void PTStore::drawTextured() const
+{
+  for(uint32_t s=0; s<systemCount; ++s) {
+    systems[s]->drawTextured();
+  }
+}
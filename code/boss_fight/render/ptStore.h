@@ -0,0 +1,66 @@
+/**
+* @copyright 2024 - Max Bebök
+* @license MIT
+*/
+#pragma once
+#include <t3d/t3d.h>
+#include <t3d/tpx.h>
+#include <vector>
+
+#include "ptSystem.h"
+
+/**
+ * Particles spread along the X-axis, simulated in float arrays (SoA).
+ * Before drawing, particles are binned into X-sections of 'SECTION_SIZE',
+ * sections outside the camera are skipped and only visible ones get packed into tpx buffers.
+ * Buffers are pooled and grow on demand, so there is no limit per section.
+ */
+class PTStore
+{
+  private:
+    constexpr static uint32_t SYSTEM_SIZE = 128; // particles per tpx buffer
+
+    float offsetY{};
+    float scaleY{};
+
+    std::vector<PTSystem*> systems{};
+    uint32_t systemCount{0}; // used in the last pack()
+
+    std::vector<int32_t> partSection{};
+    std::vector<uint32_t> partOrder{}; // visible particles, grouped by section
+    std::vector<uint32_t> sectionCount{};
+    std::vector<uint32_t> sectionOffset{}; // into 'partOrder', one extra entry for the end
+
+    PTSystem* getSystem(float sectionX);
+
+  public:
+    constexpr static float SECTION_SIZE = 256.0f;
+
+    std::vector<float> posX{};
+    std::vector<float> posY{};
+    std::vector<float> posZ{};
+    std::vector<float> size{}; // in tpx units (0-127)
+    std::vector<color_t> color{};
+
+    /**
+     * @param offsetY center of the Y-range particles can be in
+     * @param scaleY precision in Y, the range is +-127/scaleY around 'offsetY'
+     */
+    PTStore(float offsetY, float scaleY);
+    ~PTStore();
+
+    [[nodiscard]] uint32_t count() const { return posX.size(); }
+    [[nodiscard]] bool isInRangeY(float y) const {
+      float localY = (y - offsetY) * scaleY;
+      return localY >= -127.0f && localY <= 127.0f;
+    }
+    [[nodiscard]] float getMaxY() const { return offsetY + 126.0f / scaleY; }
+
+    void add(const T3DVec3 &pos, float ptSize, color_t col);
+    void remove(uint32_t index);
+    void clear();
+
+    // bins, culls and packs all particles, must be called before draw()
+    void pack();
+    void drawTextured() const;
+};
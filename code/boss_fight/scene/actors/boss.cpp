@@ -279,8 +279,11 @@ void Actor::Boss::update(float deltaTime) {
     scale *= 0.9f;
     data_cache_hit_writeback(&matFP[p], sizeof(T3DMat4FP));
 
-    auto rayRes = collScene.raycastFloor(coll.center);
-    Shadows::addShadow(rayRes.hitPos * COLL_WORLD_SCALE + T3DVec3{0, 0.1f, 0}, {0,1,0}, 30.0f * scale, 1.0f);
+    // the floor is only needed for the shadow, skip it when off-screen
+    if(Shadows::isVisible(coll.center * COLL_WORLD_SCALE, 30.0f * scale)) {
+      auto rayRes = collScene.raycastFloor(coll.center, &floorCache[p]);
+      Shadows::addShadow(rayRes.hitPos * COLL_WORLD_SCALE + T3DVec3{0, 0.1f, 0}, {0,1,0}, 30.0f * scale, 1.0f);
+    }
     ++p;
   }
 }
@@ -4,7 +4,7 @@
 */
 #pragma once
 #include "base.h"
-#include "../../collision/shapes.h"
+#include "../../collision/scene.h"
 #include "../healthMeter.h"
 #include "../../main.h"
 
@@ -16,6 +16,7 @@ namespace Actor
       constexpr static int PART_COUNT = 5;
 
       Coll::Sphere collider[PART_COUNT]{};
+      Coll::FloorCache floorCache[PART_COUNT]{}; // for the shadows
       T3DVec3 pos2D{};
 
       float faceDir{0.0f};
@@ -126,7 +126,7 @@ void Actor::Box::update(float deltaTime)
     );
   }
 
-  auto res = scene.getCollScene().raycastFloor(coll.center);
+  auto res = scene.getCollScene().raycastFloor(coll.center, &floorCache);
   if(isHit) {
     coll.velocity.y -= 17.0f * deltaTime;
     rotAngle += deltaTime * 4.0f;
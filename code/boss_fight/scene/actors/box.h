@@ -5,7 +5,7 @@
 #pragma once
 #include <t3d/t3dskeleton.h>
 #include "base.h"
-#include "../../collision/shapes.h"
+#include "../../collision/scene.h"
 
 namespace Actor
 {
@@ -13,6 +13,7 @@ namespace Actor
   {
     private:
       T3DMat4FP *matFP{};
+      Coll::FloorCache floorCache{};
       float rotAngle{0};
       uint16_t param{0};
       uint8_t isHit{false};
@@ -97,7 +97,7 @@ void Actor::Coin::update(float deltaTime)
       {
         uint32_t timeSliceIdx = (scene.frameIdx % TIME_SLICES) + 1;
         if(timeSliceIdx == (getTimeSliceIdx())) {
-          auto floor = scene.getCollScene().raycastFloor(coll.center);
+          auto floor = scene.getCollScene().raycastFloor(coll.center, &floorCache);
           if(floor.collCount) {
             floorPosY = floor.hitPos.y * COLL_WORLD_SCALE;
             //floorPosY += 0.5f;
@@ -4,13 +4,14 @@
 */
 #pragma once
 #include "base.h"
-#include "../../collision/shapes.h"
+#include "../../collision/scene.h"
 
 namespace Actor
 {
   class Coin final : public Base
   {
     private:
+      Coll::FloorCache floorCache{};
       T3DVec3 floorNorm{0,1,0};
       float floorPosY{0.0f};
       uint16_t param{0};
@@ -13,55 +13,31 @@ namespace
   uint32_t refCount = 0;
   uint8_t grassFxTCooldown = 0;
 
-  color_t colorMul(color_t color, uint8_t mul)
+  /**
+   * Loads grass baked by 'png_to_grass' straight into the particle buffer.
+   * The file holds a blade count followed by the particles in the tpx layout.
+   * Each instance gets its own random offset per blade.
+   */
+  int loadGrass(TPXParticle *particles, int partCount, int seed, uint16_t arg)
   {
-    return (color_t){
-      (uint8_t)(color.r * mul / 255),
-      (uint8_t)(color.g * mul / 255),
-      (uint8_t)(color.b * mul / 255),
-      color.a
-    };
-  }
-
-  int generateGrass(TPXParticle *particles, int partCount, int seed, uint16_t arg)
-  {
-    char path[] = FS_BASE_PATH "grass/0.rgba32.sprite\0";
-    path[sizeof(path)-17] = '0' + arg;
-    sprite_t *grassTex = sprite_load(path);
-
-    color_t *heightMap = static_cast<color_t *>(sprite_get_pixels(grassTex).buffer);
-
-    int p = 0;
-    for(uint32_t z=0; z<grassTex->height; ++z)
-    {
-      for(uint32_t x=0; x<grassTex->width; ++x) {
-        if(p >= partCount) {
-          z = grassTex->height;
-          break;
-        }
-
-        auto color = heightMap[z * grassTex->width + x];
-        if(color.a  < 64)continue;
-        color.a >>= 1;
-
-        int8_t *ptPosA = tpx_buffer_get_pos(particles, p);
-        auto *ptColorA = (color_t*)tpx_buffer_get_rgba(particles, p);
-        *ptColorA = colorMul(color, 230);
-
-        int rndA = (Math::noise2d(x+seed, z+seed) % 3) - 1;
-        int rndB = (Math::noise2d(z+seed, x-seed) % 3) - 1;
-
-        ptPosA[0] = (x - grassTex->width/2) * 3 + rndA;
-        ptPosA[1] = 1;
-        ptPosA[2] = (z - grassTex->height/2) * -3 + rndB;
-
-        *tpx_buffer_get_size(particles, p) = 120;
-        ++p;
-      }
+    char path[] = FS_BASE_PATH "grass/0.grass\0";
+    path[sizeof(path)-9] = '0' + arg;
+    FILE *file = asset_fopen(path, nullptr);
+
+    uint32_t count = 0;
+    fread(&count, sizeof(count), 1, file);
+    count = (count > (uint32_t)partCount ? partCount : count) & ~1;
+    fread(particles, sizeof(TPXParticle), count / 2, file);
+    fclose(file);
+
+    for(uint32_t p=0; p<count; ++p) {
+      int8_t *ptPos = tpx_buffer_get_pos(particles, p);
+      int x = ptPos[0];
+      int z = ptPos[2];
+      ptPos[0] += (Math::noise2d(x+seed, z+seed) % 3) - 1;
+      ptPos[2] += (Math::noise2d(z+seed, x-seed) % 3) - 1;
     }
-
-    sprite_free(grassTex);
-    return p & ~1;
+    return count;
   }
 }
 
@@ -74,8 +50,8 @@ Actor::Grass::Grass(Scene &scene, const T3DVec3 &pos, uint16_t param)
   drawMask = 0;
   coll.center = pos;
 
-  ptSystem.count = generateGrass(ptSystem.particles, ptSystem.countMax, rand(), param);
-  //debugf("Generated %ld particles\n", ptSystem.count);
+  ptSystem.count = loadGrass(ptSystem.particles, ptSystem.countMax, rand(), param);
+  //debugf("Loaded %ld particles\n", ptSystem.count);
   spawnThreshold = ptSystem.count - 100;
 
   for(auto &fx : ptFX) {
@@ -317,13 +317,16 @@ void Player::update(const InputState &input, float deltaTime)
   );
   data_cache_hit_writeback(&matFP, sizeof(T3DMat4FP));
 
-  auto floorPos = scene.getCollScene().raycastFloor(collider.center);
-  floorPos.hitPos *= 16.0f;
-
   auto headPos = posWorld + T3DVec3{0,10.0f,0};
   t3d_viewport_calc_viewspace_pos(NULL, &pos2D, &headPos);
-  if(floorPos.collCount) {
-    Shadows::addShadow(floorPos.hitPos - T3DVec3 {{0,-0.1f,0}}, floorPos.normal, 1.0f, 1.0f);
+
+  // the floor is only needed for the shadow, skip it when off-screen
+  if(Shadows::isVisible(posWorld, 1.0f)) {
+    auto floorPos = scene.getCollScene().raycastFloor(collider.center, &floorCache);
+    floorPos.hitPos *= 16.0f;
+    if(floorPos.collCount) {
+      Shadows::addShadow(floorPos.hitPos - T3DVec3 {{0,-0.1f,0}}, floorPos.normal, 1.0f, 1.0f);
+    }
   }
 
   // OOB / fall-off check
@@ -16,6 +16,7 @@ class Player
   private:
     Coll::Sphere collider{};
     Coll::Sphere collSword{};
+    Coll::FloorCache floorCache{};
     T3DVec3 pos2D{};
     T3DVec3 hurtVel{};
 
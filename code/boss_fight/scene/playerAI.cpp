@@ -9,6 +9,29 @@
 using CT = Coll::CollType;
 
 namespace {
+  constexpr uint32_t MAX_AI_COUNT = 4;
+  constexpr float NAV_POINT_MIN_AHEAD = 1.0f;
+  constexpr float NAV_POINT_MAX_DIST2 = 100.0f;
+}
+
+void PlayerAI::updateNavPoints(PlayerAI *ais, uint32_t count, const Coll::NavPoints &navPoints)
+{
+  T3DVec3 pos[MAX_AI_COUNT];
+  Coll::NavPointsRes res[MAX_AI_COUNT];
+  PlayerAI *queryAIs[MAX_AI_COUNT];
+  uint32_t queryCount = 0;
+
+  // query every AI, even one with a nav-point may lose it in update() before it would use this
+  for(uint32_t i=0; i<count && queryCount < MAX_AI_COUNT; ++i) {
+    ais[i].navPointNext = {};
+    pos[queryCount] = ais[i].player.getPos();
+    queryAIs[queryCount++] = &ais[i];
+  }
+
+  navPoints.getClosest(pos, res, queryCount, NAV_POINT_MIN_AHEAD, NAV_POINT_MAX_DIST2);
+  for(uint32_t i=0; i<queryCount; ++i) {
+    queryAIs[i]->navPointNext = res[i];
+  }
 }
 
 InputState PlayerAI::update(float deltaTime) {
@@ -48,7 +71,7 @@ InputState PlayerAI::update(float deltaTime) {
   // raycast ahead
   auto nextPos = player.getPos() + res.move * 0.5f;
 
-  auto nextFloor = scene.getCollScene().raycastFloor(nextPos + T3DVec3{{0, 5.0f, 0}});
+  auto nextFloor = scene.getCollScene().raycastFloor(nextPos + T3DVec3{{0, 5.0f, 0}}, &floorCache);
   bool nextNoFloor = nextFloor.collCount == 0;
   float heightDiff = nextFloor.hitPos.y - player.getPos().y;
 
@@ -67,11 +90,8 @@ InputState PlayerAI::update(float deltaTime) {
   // check if we have a guide-point ahead of us
   if(!againstWall) {
 
-    if(!lastNavPoint.point) {
-      auto navPoint = scene.getNavPoints().getClosest(player.getPos(), 1.0f);
-      if(navPoint.point && navPoint.dist2 < 100.0f) {
-        lastNavPoint = navPoint;
-      }
+    if(!lastNavPoint.point && navPointNext.point) {
+      lastNavPoint = navPointNext;
     }
 
     if(lastNavPoint.point) {
@@ -264,7 +284,7 @@ InputState PlayerAI::update(float deltaTime) {
   if(action == Action::ATTACK || action == Action::COLLECT) {
     // check once more if floor is ahead
     nextPos = player.getPos() + res.move * 0.5f;
-    nextFloor = scene.getCollScene().raycastFloor(nextPos + T3DVec3{{0, 5.0f, 0}});
+    nextFloor = scene.getCollScene().raycastFloor(nextPos + T3DVec3{{0, 5.0f, 0}}, &floorCache);
     if(nextFloor.collCount == 0) {
       res.move = preAttackMove;
     } else {
@@ -13,6 +13,7 @@
 #include "actors/boss.h"
 #include "actors/coin.h"
 #include "../collision/navPoints.h"
+#include "../collision/scene.h"
 
 class Scene;
 
@@ -37,6 +38,8 @@ class PlayerAI
     float randTimeEnd{5.0f};
     bool moveOut{false};
     Coll::NavPointsRes lastNavPoint{};
+    Coll::NavPointsRes navPointNext{}; // closest one ahead, see updateNavPoints()
+    Coll::FloorCache floorCache{}; // lookahead ray
     Action action{Action::COLLECT};
 
     float jumpHoldTime{0.0f};
@@ -53,6 +56,12 @@ class PlayerAI
       : player{player}, scene{scene}
     {}
 
+    /**
+     * Finds the next nav-point for all AIs that need one in a single query.
+     * Must be called before any of them moves, 'update()' then picks up the result.
+     */
+    static void updateNavPoints(PlayerAI *ais, uint32_t count, const Coll::NavPoints &navPoints);
+
     InputState update(float deltaTime);
     void debugDraw();
 };
\ No newline at end of file
@@ -160,6 +160,8 @@ void Scene::update(float deltaTime) {
   collScene.ticks = 0;
   collScene.ticksBVH = 0;
   collScene.raycastCount = 0;
+  collScene.raycastCacheHits = 0;
+  collScene.pairCount = 0;
 
   if(!pauseMenu.isPaused) {
     switch(state) {
@@ -252,6 +254,9 @@ void Scene::updateGame(float deltaTime)
   ticksActorUpdate = get_ticks();
   // Players / Boss
   uint32_t playerCount = forceAI ? 0 : core_get_playercount();
+  if(!overrideInput && playerCount < 4) {
+    PlayerAI::updateNavPoints(&playerAI[playerCount], 4 - playerCount, navPoints);
+  }
   for(uint32_t i=0; i<4; ++i)
   {
     if(!overrideInput) {
@@ -160,6 +160,7 @@ class Scene
     const Player &getPlayer(int index) const { return players[index]; }
     const std::vector<Actor::Base*>& getActors() const { return actors; }
     Camera& getCamera() { return cam; }
+    const CulledModel& getMapModel() const { return mapModel; }
 
     const T3DVec3& getClosesRespawn(const T3DVec3 &pos) const;
 
@@ -9,6 +9,9 @@ namespace Shadows
   constexpr int MAX_SHADOWS = 16 * 4;
   constexpr float SCALE_FACTOR = 4.0f;
   constexpr uint32_t MAX_VERTICES = 68; // t3d has 70, but we need it divisible by 4
+  constexpr float SIZE_WORLD = 20.0f / SCALE_FACTOR; // half-extent of a shadow with size 1.0
+  constexpr float FLOOR_MARGIN = 64.0f; // how far below a caster its floor may be
+  constexpr float CULL_MARGIN = 8.0f; // the frustum is from the last frame, covers camera movement since then
 
   uint32_t shadowCount = 0;
   uint32_t vertOffset = 0;
@@ -81,73 +84,80 @@ void Shadows::destroy() {
   rspq_block_free(setupDPL);
 }
 
+bool Shadows::isVisible(const T3DVec3 &pos, float size) {
+  float extent = size * SIZE_WORLD + CULL_MARGIN;
+  T3DVec3 aabbMin{{pos.x - extent, pos.y - FLOOR_MARGIN, pos.z - extent}};
+  T3DVec3 aabbMax{{pos.x + extent, pos.y + extent, pos.z + extent}};
+  return t3d_frustum_vs_aabb(&t3d_viewport_get()->viewFrustum, &aabbMin, &aabbMax);
+}
+
 void Shadows::addShadow(const T3DVec3 &pos, const T3DVec3 &normal, float size, float strength) {
+  if(shadowCount >= MAX_SHADOWS || !isVisible(pos, size))return;
   size *= 20;
 
-  if (shadowCount < MAX_SHADOWS) {
-    auto posA = t3d_vertbuffer_get_pos(vertices, vertOffset+0);
-    auto posB = t3d_vertbuffer_get_pos(vertices, vertOffset+1);
-    auto posC = t3d_vertbuffer_get_pos(vertices, vertOffset+2);
-    auto posD = t3d_vertbuffer_get_pos(vertices, vertOffset+3);
-
-    // flat floors are very likely, so we can optimize this case
-    if(normal.y > 0.95f) {
-      T3DVec3 posScaled{
-        pos.x * SCALE_FACTOR,
-        (pos.y + normal.y) * SCALE_FACTOR,
-        pos.z * SCALE_FACTOR
-      };
-
-      posA[0] = posScaled.x - size;
-      posA[1] = posScaled.y;
-      posA[2] = posScaled.z - size;
-
-      posB[0] = posScaled.x + size;
-      posB[1] = posScaled.y;
-      posB[2] = posScaled.z - size;
-
-      posC[0] = posScaled.x + size;
-      posC[1] = posScaled.y;
-      posC[2] = posScaled.z + size;
-
-      posD[0] = posScaled.x - size;
-      posD[1] = posScaled.y;
-      posD[2] = posScaled.z + size;
-    } else {
-      // ...otherwise we need to calculate the vectors to make a shadow plane
-      auto posScaled = (pos + normal) * SCALE_FACTOR;
-      T3DVec3 right, up;
-      t3d_vec3_cross(right, normal, {0,1,0});
-      t3d_vec3_cross(up, right, normal);
-      t3d_vec3_norm(&right);
-      t3d_vec3_norm(&up);
-
-      auto vecA = (right - up) * size;
-      auto vecB = (right + up) * size;
-
-      posA[0] = posScaled.x - vecA.x;
-      posA[1] = posScaled.y - vecA.y;
-      posA[2] = posScaled.z - vecA.z;
-
-      posB[0] = posScaled.x + vecA.x;
-      posB[1] = posScaled.y + vecA.y;
-      posB[2] = posScaled.z + vecA.z;
-
-      posC[0] = posScaled.x + vecB.x;
-      posC[1] = posScaled.y + vecB.y;
-      posC[2] = posScaled.z + vecB.z;
-
-      posD[0] = posScaled.x - vecB.x;
-      posD[1] = posScaled.y - vecB.y;
-      posD[2] = posScaled.z - vecB.z;
-    }
-
-    ++shadowCount;
-    vertOffset += 4;
+  auto posA = t3d_vertbuffer_get_pos(vertices, vertOffset+0);
+  auto posB = t3d_vertbuffer_get_pos(vertices, vertOffset+1);
+  auto posC = t3d_vertbuffer_get_pos(vertices, vertOffset+2);
+  auto posD = t3d_vertbuffer_get_pos(vertices, vertOffset+3);
+
+  // flat floors are very likely, so we can optimize this case
+  if(normal.y > 0.95f) {
+    T3DVec3 posScaled{
+      pos.x * SCALE_FACTOR,
+      (pos.y + normal.y) * SCALE_FACTOR,
+      pos.z * SCALE_FACTOR
+    };
+
+    posA[0] = posScaled.x - size;
+    posA[1] = posScaled.y;
+    posA[2] = posScaled.z - size;
+
+    posB[0] = posScaled.x + size;
+    posB[1] = posScaled.y;
+    posB[2] = posScaled.z - size;
+
+    posC[0] = posScaled.x + size;
+    posC[1] = posScaled.y;
+    posC[2] = posScaled.z + size;
+
+    posD[0] = posScaled.x - size;
+    posD[1] = posScaled.y;
+    posD[2] = posScaled.z + size;
+  } else {
+    // ...otherwise we need to calculate the vectors to make a shadow plane
+    auto posScaled = (pos + normal) * SCALE_FACTOR;
+    T3DVec3 right, up;
+    t3d_vec3_cross(right, normal, {0,1,0});
+    t3d_vec3_cross(up, right, normal);
+    t3d_vec3_norm(&right);
+    t3d_vec3_norm(&up);
+
+    auto vecA = (right - up) * size;
+    auto vecB = (right + up) * size;
+
+    posA[0] = posScaled.x - vecA.x;
+    posA[1] = posScaled.y - vecA.y;
+    posA[2] = posScaled.z - vecA.z;
+
+    posB[0] = posScaled.x + vecA.x;
+    posB[1] = posScaled.y + vecA.y;
+    posB[2] = posScaled.z + vecA.z;
+
+    posC[0] = posScaled.x + vecB.x;
+    posC[1] = posScaled.y + vecB.y;
+    posC[2] = posScaled.z + vecB.z;
+
+    posD[0] = posScaled.x - vecB.x;
+    posD[1] = posScaled.y - vecB.y;
+    posD[2] = posScaled.z - vecB.z;
   }
+
+  ++shadowCount;
+  vertOffset += 4;
 }
 
 void Shadows::draw() {
+  if(shadowCount == 0)return;
   rspq_block_run(setupDPL);
   uint32_t count = shadowCount * 4;
   auto vert = vertices;
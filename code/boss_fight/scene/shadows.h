@@ -11,6 +11,13 @@ namespace Shadows
   void init();
   void destroy();
 
+  /**
+   * Checks if a shadow around the given position (world-space) could be on screen.
+   * The floor may be below 'pos', so callers can use this to skip their floor lookup.
+   */
+  bool isVisible(const T3DVec3 &pos, float size);
+
+  // shadows outside the camera are culled here, 'pos' must be on the floor
   void addShadow(const T3DVec3 &pos, const T3DVec3 &normal, float size, float strength = 1.0f);
   void draw();
   void reset();
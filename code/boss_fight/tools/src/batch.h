@@ -0,0 +1,210 @@
+/**
+* @copyright 2024 - Max Bebök
+* @license MIT
+*/
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <functional>
+#include <algorithm>
+#include <unordered_map>
+#include "lib/cgltf.h"
+#include "bvh/v2/thread_pool.h"
+
+/**
+ * Shared command line handling for the converters.
+ * Both take either a single input/output pair, or any number of them plus options:
+ *
+ *   gltf_to_xxx [-j threads] [-c cache.txt] [--flag ...] in0.glb out0 in1.glb out1 ...
+ *
+ * Pairs are converted in parallel. With a cache file, every output remembers a hash
+ * of its glTF and external buffers, and is skipped if neither changed since.
+ * Converter specific options start with '--' and are queried via hasFlag() or getFlagValue().
+ */
+namespace Batch
+{
+  inline std::vector<std::string> flags{};
+
+  inline bool hasFlag(const char* flag) {
+    return std::find(flags.begin(), flags.end(), flag) != flags.end();
+  }
+
+  // value of a '--flag=value' option, nullptr if not set
+  inline const char* getFlagValue(const char* flag) {
+    size_t len = strlen(flag);
+    for(auto &f : flags) {
+      if(f.size() > len && f.compare(0, len, flag) == 0 && f[len] == '=')return f.c_str() + len + 1;
+    }
+    return nullptr;
+  }
+
+  using ConvertFunc = std::function<void(const char* gltfPath, const char* outPath)>;
+
+  struct Job {
+    std::string gltfPath{};
+    std::string outPath{};
+    uint64_t hash{};
+  };
+
+  inline uint64_t hashBytes(uint64_t hash, const std::vector<char> &data) {
+    // FNV-1a
+    for(char c : data) {
+      hash ^= (uint8_t)c;
+      hash *= 0x100000001B3ull;
+    }
+    return hash;
+  }
+
+  inline bool readFile(const std::filesystem::path &path, std::vector<char> &out) {
+    std::ifstream file{path, std::ios::binary};
+    if(!file)return false;
+    out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+  }
+
+  /**
+   * Hashes a glTF file together with every external buffer it references.
+   * 'version' should change whenever the output format of a converter does.
+   */
+  inline uint64_t hashGltf(const std::string &gltfPath, const char* version)
+  {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    std::vector<char> data{version, version + strlen(version)};
+    hash = hashBytes(hash, data);
+
+    if(!readFile(gltfPath, data))return 0;
+    hash = hashBytes(hash, data);
+
+    cgltf_options options{};
+    cgltf_data* gltf = nullptr;
+    if(cgltf_parse(&options, data.data(), data.size(), &gltf) != cgltf_result_success)return 0;
+
+    auto basePath = std::filesystem::path{gltfPath}.parent_path();
+    for(cgltf_size i=0; i<gltf->buffers_count; ++i) {
+      const char* uri = gltf->buffers[i].uri;
+      if(!uri || strncmp(uri, "data:", 5) == 0)continue;
+
+      std::string uriDecoded{uri};
+      uriDecoded.resize(cgltf_decode_uri(uriDecoded.data()));
+      std::vector<char> buffer{};
+      if(readFile(basePath / uriDecoded, buffer))hash = hashBytes(hash, buffer);
+    }
+    cgltf_free(gltf);
+    return hash;
+  }
+
+  inline std::unordered_map<std::string, uint64_t> readCache(const std::string &path)
+  {
+    std::unordered_map<std::string, uint64_t> res{};
+    std::ifstream file{path};
+    std::string line{};
+    while(std::getline(file, line)) {
+      std::istringstream ss{line};
+      std::string hashStr{}, outPath{};
+      if(ss >> hashStr >> std::ws && std::getline(ss, outPath)) {
+        res[outPath] = std::stoull(hashStr, nullptr, 16);
+      }
+    }
+    return res;
+  }
+
+  inline void writeCache(const std::string &path, const std::unordered_map<std::string, uint64_t> &cache)
+  {
+    FILE* file = fopen(path.c_str(), "w");
+    if(!file)return;
+    for(auto &[outPath, hash] : cache) {
+      fprintf(file, "%016llx %s\n", (unsigned long long)hash, outPath.c_str());
+    }
+    fclose(file);
+  }
+
+  /**
+   * Parses the command line and runs the converter on every pair.
+   * @return exit code for main()
+   */
+  inline int run(int argc, char** argv, const char* version, const ConvertFunc &convert)
+  {
+    std::vector<Job> jobs{};
+    std::string cachePath{};
+    size_t threadCount = 0;
+
+    for(int i=1; i<argc; ++i) {
+      if(strcmp(argv[i], "-j") == 0 && i+1 < argc) {
+        threadCount = std::stoul(argv[++i]);
+      } else if(strcmp(argv[i], "-c") == 0 && i+1 < argc) {
+        cachePath = argv[++i];
+      } else if(strncmp(argv[i], "--", 2) == 0) {
+        flags.push_back(argv[i]);
+      } else if(i+1 < argc) {
+        jobs.push_back({argv[i], argv[i+1]});
+        ++i;
+      } else {
+        jobs.clear();
+        break;
+      }
+    }
+
+    if(jobs.empty()) {
+      fprintf(stderr, "Usage: %s [-j threads] [-c cache.txt] [--flag ...] <in.glb> <out> [<in.glb> <out> ...]\n", argv[0]);
+      return 1;
+    }
+
+    // options change the output as much as the format does
+    std::string versionFlags{version};
+    for(auto &flag : flags)versionFlags += " " + flag;
+
+    auto cache = cachePath.empty() ? decltype(readCache("")){} : readCache(cachePath);
+    std::mutex mutex{};
+    std::atomic<int> failed{0};
+    std::atomic<int> skipped{0};
+
+    auto runJob = [&](Job &job) {
+      if(!cachePath.empty()) {
+        job.hash = hashGltf(job.gltfPath, versionFlags.c_str());
+        std::lock_guard lock{mutex};
+        auto it = cache.find(job.outPath);
+        if(job.hash != 0 && it != cache.end() && it->second == job.hash && std::filesystem::exists(job.outPath)) {
+          ++skipped;
+          return;
+        }
+      }
+
+      try {
+        convert(job.gltfPath.c_str(), job.outPath.c_str());
+      } catch(const std::exception &e) {
+        fprintf(stderr, "Error: %s -> %s: %s\n", job.gltfPath.c_str(), job.outPath.c_str(), e.what());
+        ++failed;
+        return;
+      }
+
+      if(!cachePath.empty() && job.hash != 0) {
+        std::lock_guard lock{mutex};
+        cache[job.outPath] = job.hash;
+      }
+    };
+
+    if(jobs.size() == 1) {
+      runJob(jobs[0]);
+    } else {
+      bvh::v2::ThreadPool pool{threadCount};
+      for(auto &job : jobs) {
+        pool.push([&](size_t) { runJob(job); });
+      }
+      pool.wait();
+    }
+
+    if(!cachePath.empty()) {
+      writeCache(cachePath, cache);
+      if(skipped > 0)printf("Skipped %d unchanged file(s)\n", (int)skipped);
+    }
+    return failed > 0 ? 1 : 0;
+  }
+}
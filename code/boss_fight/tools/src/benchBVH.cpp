@@ -0,0 +1,324 @@
+/**
+* @copyright 2024 - Max Bebök
+* @license MIT
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <sstream>
+#include <tuple>
+
+#include "../../collision/bvh.h"
+
+/**
+ * Host benchmark for the collision BVH.
+ * Loads .coll files like Coll::Mesh::load() and runs the same sphere and floor-ray queries
+ * against each of them, using the runtime's own traversal code:
+ *
+ *   bench_bvh [-n queryCount] [-q queries.txt] a.coll [b.coll ...]
+ *
+ * Queries are random by default, or replayed from the "BVHQ ..." lines the game logs with
+ * Coll::BVH_LOG_QUERIES enabled. Results are checked against a brute-force test of each
+ * triangle's bounds, which also shows how many extra candidates a tree lets through.
+ * Timings are only meaningful relative to each other, the N64 has no comparable cache.
+ */
+namespace
+{
+  constexpr uint32_t HEADER_SIZE = 8 * sizeof(uint32_t);
+
+  struct SubMesh {
+    uint32_t triCount{};
+    std::vector<uint16_t> bvhData{};
+    std::vector<Coll::AABB> triBounds{}; // in BVH space, same conversion as gltf_to_coll
+
+    [[nodiscard]] const Coll::BVH* bvh() const { return (const Coll::BVH*)bvhData.data(); }
+  };
+
+  struct CollFile {
+    std::string path{};
+    std::vector<SubMesh> meshes{};
+    uint32_t bvhBytes{};
+  };
+
+  uint32_t readU32(const std::vector<uint8_t> &data, uint32_t offset) {
+    return (data[offset] << 24) | (data[offset+1] << 16) | (data[offset+2] << 8) | data[offset+3];
+  }
+
+  uint32_t align(uint32_t offset, uint32_t alignment) {
+    return (offset + alignment - 1) & ~(alignment - 1);
+  }
+
+  // mirrors Coll::Mesh::load(), the host can't map the file directly (pointer size, endianness)
+  CollFile loadColl(const char* path)
+  {
+    std::ifstream file{path, std::ios::binary};
+    if(!file) {
+      fprintf(stderr, "Failed to open %s\n", path);
+      exit(1);
+    }
+    std::vector<uint8_t> data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+    CollFile res{path};
+    uint32_t meshOffset = 0;
+    for(;;)
+    {
+      uint32_t triCount = readU32(data, meshOffset);
+      uint32_t vertCount = readU32(data, meshOffset + 4);
+      uint32_t nextOffset = readU32(data, meshOffset + 24);
+
+      uint32_t offsetIndices = meshOffset + HEADER_SIZE;
+      uint32_t offsetVerts = align(align(offsetIndices + triCount * sizeof(uint16_t) * 3, 4) + triCount * sizeof(Coll::IVec3), 4);
+      uint32_t offset = align(offsetVerts + vertCount * sizeof(T3DVec3), 4);
+
+      uint32_t triDataOffset = readU32(data, meshOffset + 28);
+      uint32_t bvhEnd = triDataOffset ? (meshOffset + triDataOffset)
+        : (nextOffset ? (meshOffset + nextOffset) : (uint32_t)data.size());
+      auto &mesh = res.meshes.emplace_back();
+      mesh.triCount = triCount;
+
+      for(uint32_t t=0; t<triCount; ++t) {
+        Coll::AABB aabb{{INT16_MAX, INT16_MAX, INT16_MAX}, {INT16_MIN, INT16_MIN, INT16_MIN}};
+        for(int i=0; i<3; ++i) {
+          uint32_t idx = (data[offsetIndices + (t*3+i)*2] << 8) | data[offsetIndices + (t*3+i)*2 + 1];
+          for(int c=0; c<3; ++c) {
+            uint32_t bits = readU32(data, offsetVerts + idx * sizeof(T3DVec3) + c*4);
+            float pos;
+            memcpy(&pos, &bits, sizeof(float));
+            auto posInt = (int16_t)(pos * 64.0f);
+            aabb.min.v[c] = std::min(aabb.min.v[c], posInt);
+            aabb.max.v[c] = std::max(aabb.max.v[c], posInt);
+          }
+        }
+        mesh.triBounds.push_back(aabb);
+      }
+
+      // the whole BVH is made out of 16-bit values
+      mesh.bvhData.resize((bvhEnd - offset) / sizeof(uint16_t));
+      for(size_t i=0; i<mesh.bvhData.size(); ++i) {
+        mesh.bvhData[i] = (data[offset + i*2] << 8) | data[offset + i*2 + 1];
+      }
+
+      auto bvh = mesh.bvh();
+      uint32_t nodeSize = (bvh->flags & Coll::BVH_FLAG_WIDE) ? sizeof(Coll::BVHNode4) : sizeof(Coll::BVHNode);
+      res.bvhBytes += 4 + bvh->nodeCount * nodeSize;
+
+      if(!nextOffset)break;
+      meshOffset += nextOffset;
+    }
+    return res;
+  }
+
+  Coll::AABB getBounds(const CollFile &coll)
+  {
+    Coll::AABB res{{INT16_MAX, INT16_MAX, INT16_MAX}, {INT16_MIN, INT16_MIN, INT16_MIN}};
+    auto merge = [&res](const Coll::AABB &aabb) {
+      if(aabb.min.v[0] > aabb.max.v[0])return; // unused wide slot
+      for(int i=0; i<3; ++i) {
+        res.min.v[i] = std::min(res.min.v[i], aabb.min.v[i]);
+        res.max.v[i] = std::max(res.max.v[i], aabb.max.v[i]);
+      }
+    };
+
+    for(auto &mesh : coll.meshes) {
+      auto bvh = mesh.bvh();
+      if(bvh->flags & Coll::BVH_FLAG_WIDE) {
+        for(auto &aabb : ((const Coll::BVHNode4*)bvh->nodes)->aabb)merge(aabb);
+      } else {
+        merge(bvh->nodes[0].aabb);
+      }
+    }
+    return res;
+  }
+
+  struct QueryStats {
+    double nsPerQuery{};
+    uint64_t results{};
+    uint32_t overflows{};
+    uint32_t missing{}; // queries that missed a triangle whose bounds pass the test
+    uint64_t falsePositives{}; // triangles found whose own bounds don't pass it
+  };
+
+  /**
+   * Checks all queries against a brute-force test of each triangle's bounds,
+   * then runs them a few more times for the timing.
+   */
+  template<typename QUERY, typename TEST>
+  QueryStats runQueries(const CollFile &coll, int queryCount, int rounds, QUERY query, TEST test)
+  {
+    QueryStats stats{};
+    Coll::BVHResult res{};
+    std::vector<bool> found{};
+
+    for(int q=0; q<queryCount; ++q) {
+      for(auto &mesh : coll.meshes) {
+        res.reset();
+        query(*mesh.bvh(), q, res);
+        stats.results += res.count;
+        bool overflow = res.count >= Coll::MAX_RESULT_COUNT;
+        if(overflow)++stats.overflows;
+
+        found.assign(mesh.triCount, false);
+        for(int i=0; i<res.count; ++i)found[res.triIndex[i]] = true;
+
+        bool missing = false;
+        for(uint32_t t=0; t<mesh.triCount; ++t) {
+          bool expected = test(mesh.triBounds[t], q);
+          if(found[t] && !expected)++stats.falsePositives;
+          if(!found[t] && expected)missing = true;
+        }
+        if(missing && !overflow)++stats.missing;
+      }
+    }
+
+    auto timeStart = std::chrono::steady_clock::now();
+    for(int r=0; r<rounds; ++r) {
+      for(int q=0; q<queryCount; ++q) {
+        for(auto &mesh : coll.meshes) {
+          res.reset();
+          query(*mesh.bvh(), q, res);
+        }
+      }
+    }
+    auto timeEnd = std::chrono::steady_clock::now();
+
+    stats.nsPerQuery = std::chrono::duration<double, std::nano>(timeEnd - timeStart).count() / ((double)queryCount * rounds);
+    return stats;
+  }
+}
+
+namespace
+{
+  struct Queries {
+    std::vector<Coll::AABB> spheres{};
+    std::vector<Coll::IVec3> rays{};
+  };
+
+  // query sizes roughly match the actors of the boss fight (radius in BVH units, 64 per unit)
+  Queries randomQueries(const Coll::AABB &bounds, int queryCount)
+  {
+    std::mt19937 rng{1234};
+    auto randRange = [&rng](int min, int max) {
+      return std::uniform_int_distribution<int>{min, max}(rng);
+    };
+
+    Queries res{};
+    res.spheres.resize(queryCount);
+    res.rays.resize(queryCount);
+    for(int q=0; q<queryCount; ++q) {
+      int radius = randRange(32, 64 * 4);
+      for(int i=0; i<3; ++i) {
+        int center = randRange(bounds.min.v[i], bounds.max.v[i]);
+        res.spheres[q].min.v[i] = (int16_t)std::max(center - radius, INT16_MIN);
+        res.spheres[q].max.v[i] = (int16_t)std::min(center + radius, INT16_MAX);
+        res.rays[q].v[i] = (int16_t)center;
+      }
+    }
+    return res;
+  }
+
+  // every query is run against all sub-meshes, just like they are logged once per sub-mesh
+  Queries loadQueries(const char* path)
+  {
+    std::ifstream file{path};
+    if(!file) {
+      fprintf(stderr, "Failed to open %s\n", path);
+      exit(1);
+    }
+
+    Queries res{};
+    std::string line{};
+    while(std::getline(file, line)) {
+      auto pos = line.find("BVHQ ");
+      if(pos == std::string::npos)continue;
+      std::istringstream ss{line.substr(pos + 5)};
+      char type{};
+      int v[6]{};
+      ss >> type;
+      if(type == 'S' && ss >> v[0] >> v[1] >> v[2] >> v[3] >> v[4] >> v[5]) {
+        res.spheres.push_back({
+          {(int16_t)v[0], (int16_t)v[1], (int16_t)v[2]},
+          {(int16_t)v[3], (int16_t)v[4], (int16_t)v[5]}
+        });
+      } else if(type == 'F' && ss >> v[0] >> v[1] >> v[2]) {
+        res.rays.push_back({(int16_t)v[0], (int16_t)v[1], (int16_t)v[2]});
+      }
+    }
+    return res;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  int queryCount = 20000;
+  const char* queryPath = nullptr;
+  std::vector<CollFile> files{};
+
+  for(int i=1; i<argc; ++i) {
+    if(strcmp(argv[i], "-n") == 0 && i+1 < argc) {
+      queryCount = atoi(argv[++i]);
+    } else if(strcmp(argv[i], "-q") == 0 && i+1 < argc) {
+      queryPath = argv[++i];
+    } else {
+      files.push_back(loadColl(argv[i]));
+    }
+  }
+
+  if(files.empty()) {
+    fprintf(stderr, "Usage: %s [-n queryCount] [-q queries.txt] <a.coll> [<b.coll> ...]\n", argv[0]);
+    return 1;
+  }
+
+  constexpr int ROUNDS = 20;
+  auto queries = queryPath ? loadQueries(queryPath) : randomQueries(getBounds(files[0]), queryCount);
+
+  auto querySphere = [&queries](const Coll::BVH &bvh, int q, Coll::BVHResult &res) {
+    bvh.vsAABB(queries.spheres[q], res);
+  };
+  auto queryRay = [&queries](const Coll::BVH &bvh, int q, Coll::BVHResult &res) {
+    bvh.raycastFloor(queries.rays[q], res);
+  };
+
+  int sphereCount = queries.spheres.size();
+  int rayCount = queries.rays.size();
+  printf("%d sphere and %d floor queries, %d rounds\n", sphereCount, rayCount, ROUNDS);
+
+  auto testSphere = [&queries](const Coll::AABB &triBounds, int q) {
+    return triBounds.vsAABB(queries.spheres[q]);
+  };
+  auto testRay = [&queries](const Coll::AABB &triBounds, int q) {
+    return triBounds.vs2DPointY(queries.rays[q]);
+  };
+
+  uint32_t missing = 0;
+  for(auto &coll : files) {
+    bool wide = coll.meshes[0].bvh()->flags & Coll::BVH_FLAG_WIDE;
+    uint32_t nodeCount = 0;
+    for(auto &mesh : coll.meshes)nodeCount += mesh.bvh()->nodeCount;
+
+    auto statsSphere = runQueries(coll, sphereCount, ROUNDS, querySphere, testSphere);
+    auto statsRay = runQueries(coll, rayCount, ROUNDS, queryRay, testRay);
+
+    printf("%s (%s): %d sub-mesh(es), %d nodes, %d bytes\n",
+      coll.path.c_str(), wide ? "wide" : "binary", (int)coll.meshes.size(), nodeCount, coll.bvhBytes
+    );
+    for(auto [name, stats, count] : {
+      std::tuple{"sphere", statsSphere, sphereCount},
+      std::tuple{"floor ", statsRay, rayCount}
+    }) {
+      count = std::max(count, 1);
+      printf("  %s: %8.1f ns/query, %6.2f tris/query (%5.2f false positives), %d overflows, %d missed\n",
+        name, stats.nsPerQuery, (double)stats.results / count, (double)stats.falsePositives / count,
+        stats.overflows, stats.missing
+      );
+      missing += stats.missing;
+    }
+  }
+
+  return missing == 0 ? 0 : 1;
+}
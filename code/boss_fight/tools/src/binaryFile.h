@@ -7,6 +7,8 @@
 #include <cstdio>
 #include <vector>
 #include <unordered_map>
+#include <stdexcept>
+#include <string>
 #include "bit.h"
 
 class BinaryFile
@@ -110,6 +112,9 @@ class BinaryFile
 
     void writeToFile(const char* filename) {
       FILE* file = fopen(filename, "wb");
+      if(!file) {
+        throw std::runtime_error(std::string("Failed to open ") + filename);
+      }
       fwrite(data.data(), 1, dataSize, file);
       fclose(file);
     }
@@ -10,20 +10,20 @@ namespace {
 }
 
 #include "cgltfHelper.h"
+#include "batch.h"
 
 #define CGLTF_IMPLEMENTATION
 #include "lib/cgltf.h"
 
 #include "binaryFile.h"
+#include "meshBVH.h"
 
 #include <string>
 #include <vector>
 #include <filesystem>
-
-std::vector<int16_t> createMeshBVH(
-  const std::vector<IVec3> &vertices,
-  const std::vector<uint16_t> &indices
-);
+#include <memory>
+#include <algorithm>
+#include <unordered_map>
 
 namespace fs = std::filesystem;
 
@@ -61,11 +61,269 @@ namespace {
   }
 }
 
-int main(int argc, char** argv)
+namespace {
+  // bump whenever the output format changes, so cached outputs get rebuilt
+  constexpr const char* FORMAT_VERSION = "coll-5";
+
+  // vertices closer than this get merged, half a step of the int16 positions used by the BVH
+  constexpr float WELD_TOLERANCE = 0.5f / BASE_SCALE;
+
+  // limits of a single sub-mesh, indices and triangle ids are stored as uint16
+  constexpr uint32_t MAX_SUB_MESH_VERTS = 0x10000;
+  constexpr uint32_t MAX_SUB_MESH_TRIS = 0x10000;
+
+  constexpr uint32_t HEADER_SIZE = 8 * sizeof(uint32_t);
+  constexpr uint32_t SUB_MESH_ALIGN = 8;
+
+  // must match the runtime (collision/shapes.h)
+  constexpr uint32_t TRI_TYPE_FLOOR = 1 << 0;
+  constexpr uint32_t TRI_TYPE_WALL = 1 << 1;
+  constexpr float FLOOR_ANGLE = 0.7f;
+
+  // precomputed per-triangle data for the collision checks, mirrors Coll::TriData
+  struct TriData {
+    float normal[3]{};
+    float planeDist{};
+    float baryCoeff[3]{};
+    float edgeInvLen2[3]{};
+    uint32_t type{};
+  };
+  static_assert(sizeof(TriData) == 44);
+
+  struct SubMesh {
+    std::vector<Vec3> verts{};
+    std::vector<uint16_t> indices{};
+    std::vector<IVec3> normals{};
+    std::vector<int16_t> bvh{};
+    std::vector<TriData> triData{};
+    MeshBVHStats bvhStats{};
+  };
+
+  /**
+   * BVH settings from the command line:
+   * --wide-bvh, --bvh-quality=low|medium|high, --bvh-min-leaf=N, --bvh-max-leaf=N (1-15), --bvh-node-cost=F
+   */
+  MeshBVHConfig getBVHConfig()
+  {
+    MeshBVHConfig config{};
+    config.wide = Batch::hasFlag("--wide-bvh");
+
+    if(auto quality = Batch::getFlagValue("--bvh-quality")) {
+      std::string q{quality};
+      if(q == "low")config.quality = 0;
+      else if(q == "medium")config.quality = 1;
+      else if(q == "high")config.quality = 2;
+      else throw std::runtime_error("Invalid --bvh-quality, must be low, medium or high");
+    }
+    if(auto size = Batch::getFlagValue("--bvh-min-leaf"))config.minLeafSize = std::stoi(size);
+    if(auto size = Batch::getFlagValue("--bvh-max-leaf"))config.maxLeafSize = std::stoi(size);
+    if(auto cost = Batch::getFlagValue("--bvh-node-cost"))config.nodeCost = std::stod(cost);
+
+    if(config.maxLeafSize < 1 || config.maxLeafSize > 15 || config.minLeafSize < 1 || config.minLeafSize > config.maxLeafSize) {
+      throw std::runtime_error("Invalid BVH leaf size, must be 1 <= min <= max <= 15");
+    }
+    return config;
+  }
+
+  void printBVHStats(const char* gltfPath, int subMeshIndex, const MeshBVHStats &stats)
+  {
+    std::string leafSizes{};
+    for(int i=1; i<16; ++i) {
+      if(stats.leafSizes[i])leafSizes += " " + std::to_string(i) + ":" + std::to_string(stats.leafSizes[i]);
+    }
+    std::string wide = stats.wideNodeCount ? (", " + std::to_string(stats.wideNodeCount) + " wide nodes") : "";
+
+    printf("%s: BVH %d: %d nodes, %d leaves, depth %d, SAH cost %.2f, sibling overlap %.1f%%%s\n%s: BVH %d: leaf sizes%s\n",
+      gltfPath, subMeshIndex, (int)stats.nodeCount, (int)stats.leafCount, (int)stats.depth,
+      stats.sahCost, stats.overlap * 100.0, wide.c_str(),
+      gltfPath, subMeshIndex, leafSizes.c_str()
+    );
+  }
+
+  /**
+   * Merges vertices within 'tolerance' of each other, using a hash-grid with the tolerance as cell size.
+   * @return maps each input vertex to the index of the first vertex it was merged with
+   */
+  std::vector<uint32_t> weldVertices(const std::vector<Vec3> &verts, float tolerance)
+  {
+    auto cellKey = [](int64_t x, int64_t y, int64_t z) {
+      return ((uint64_t)(x & 0x1FFFFF) << 42) | ((uint64_t)(y & 0x1FFFFF) << 21) | (uint64_t)(z & 0x1FFFFF);
+    };
+
+    std::unordered_map<uint64_t, std::vector<uint32_t>> grid{};
+    std::vector<uint32_t> res(verts.size());
+    float tolerance2 = tolerance * tolerance;
+
+    for(uint32_t i=0; i<verts.size(); ++i)
+    {
+      const auto &v = verts[i];
+      int64_t cell[3];
+      for(int c=0; c<3; ++c)cell[c] = (int64_t)floorf(v[c] / tolerance);
+
+      res[i] = i;
+      for(int n=0; n<27 && res[i] == i; ++n) {
+        auto it = grid.find(cellKey(cell[0] + n%3 - 1, cell[1] + (n/3)%3 - 1, cell[2] + n/9 - 1));
+        if(it == grid.end())continue;
+        for(uint32_t other : it->second) {
+          Vec3 diff = verts[other] - v;
+          if(diff.dot(diff) <= tolerance2) {
+            res[i] = other;
+            break;
+          }
+        }
+      }
+      if(res[i] == i)grid[cellKey(cell[0], cell[1], cell[2])].push_back(i);
+    }
+    return res;
+  }
+
+  /**
+   * Fills a sub-mesh with a set of triangles in the given order.
+   * Only vertices referenced by the triangles are kept, in order of first use.
+   * @return false if it needs more vertices than a sub-mesh can index
+   */
+  bool fillSubMesh(
+    const std::vector<uint32_t> &tris, const std::vector<Vec3> &verts,
+    const std::vector<uint32_t> &indices, const std::vector<IVec3> &normals,
+    SubMesh &subMesh
+  ) {
+    subMesh = {};
+    std::unordered_map<uint32_t, uint16_t> vertMap{};
+
+    for(uint32_t t : tris) {
+      for(int i=0; i<3; ++i) {
+        uint32_t idx = indices[t*3 + i];
+        auto it = vertMap.find(idx);
+        if(it == vertMap.end()) {
+          if(subMesh.verts.size() == MAX_SUB_MESH_VERTS)return false;
+          it = vertMap.emplace(idx, (uint16_t)subMesh.verts.size()).first;
+          subMesh.verts.push_back(verts[idx]);
+        }
+        subMesh.indices.push_back(it->second);
+      }
+      subMesh.normals.push_back(normals[t]);
+    }
+    return true;
+  }
+
+  /**
+   * Precomputes everything the runtime would otherwise derive from the vertices on each check:
+   * float normal and plane distance, the barycentric terms of 'getTriBaryCoord' already divided
+   * by its denominator, and the inverse squared length of each edge.
+   */
+  std::vector<TriData> createTriData(const SubMesh &subMesh)
+  {
+    std::vector<TriData> res{};
+    for(size_t t=0; t<subMesh.normals.size(); ++t)
+    {
+      const Vec3 &a = subMesh.verts[subMesh.indices[t*3]];
+      const Vec3 &b = subMesh.verts[subMesh.indices[t*3+1]];
+      const Vec3 &c = subMesh.verts[subMesh.indices[t*3+2]];
+      TriData &tri = res.emplace_back();
+
+      Vec3 normal = (b - a).cross(c - a);
+      normal = normal * (1.0f / sqrtf(normal.dot(normal)));
+      for(int i=0; i<3; ++i)tri.normal[i] = normal[i];
+      tri.planeDist = normal.dot(a);
+
+      Vec3 v0 = c - a;
+      Vec3 v1 = b - a;
+      float dot00 = v0.dot(v0);
+      float dot01 = v0.dot(v1);
+      float dot11 = v1.dot(v1);
+      float denom = dot00 * dot11 - dot01 * dot01;
+      if(denom != 0.0f) {
+        tri.baryCoeff[0] = dot11 / denom;
+        tri.baryCoeff[1] = dot01 / denom;
+        tri.baryCoeff[2] = dot00 / denom;
+      }
+
+      const Vec3* verts[3]{&a, &b, &c};
+      for(int e=0; e<3; ++e) {
+        Vec3 edge = *verts[(e+1) % 3] - *verts[e];
+        float len2 = edge.dot(edge);
+        tri.edgeInvLen2[e] = len2 > 0.0f ? (1.0f / len2) : 0.0f;
+      }
+
+      // same classification as the int16 normals at runtime
+      bool isFloor = subMesh.normals[t].pos[1] > (int16_t)(0x7FFF * FLOOR_ANGLE);
+      tri.type = isFloor ? TRI_TYPE_FLOOR : TRI_TYPE_WALL;
+    }
+    return res;
+  }
+
+  /**
+   * Creates a sub-mesh from a set of triangles, or splits it in half along its longest axis
+   * if it has too many vertices/triangles or the BVH can't encode it.
+   * Triangles are stored in BVH leaf order, so each leaf covers a contiguous range of them
+   * and nearby triangles (and their vertices) end up next to each other in memory.
+   */
+  void buildSubMeshes(
+    std::vector<uint32_t> &tris, const std::vector<Vec3> &verts,
+    const std::vector<uint32_t> &indices, const std::vector<IVec3> &normals,
+    const MeshBVHConfig &bvhConfig, std::vector<SubMesh> &out
+  ) {
+    SubMesh subMesh{};
+    if(tris.size() <= MAX_SUB_MESH_TRIS && fillSubMesh(tris, verts, indices, normals, subMesh)) {
+      std::vector<IVec3> vertsInt{};
+      for(auto &v : subMesh.verts) {
+        vertsInt.push_back({
+          (int16_t)(v[0] * BASE_SCALE),
+          (int16_t)(v[1] * BASE_SCALE),
+          (int16_t)(v[2] * BASE_SCALE)
+        });
+      }
+      try {
+        std::vector<uint32_t> primOrder{};
+        MeshBVHStats bvhStats{};
+        auto bvh = createMeshBVH(vertsInt, subMesh.indices, bvhConfig, primOrder, bvhStats);
+
+        // same set of triangles and vertices, so this always fits again
+        std::vector<uint32_t> trisSorted{};
+        for(uint32_t p : primOrder)trisSorted.push_back(tris[p]);
+        fillSubMesh(trisSorted, verts, indices, normals, subMesh);
+
+        subMesh.bvh = std::move(bvh);
+        subMesh.bvhStats = bvhStats;
+        if(Batch::hasFlag("--tri-data"))subMesh.triData = createTriData(subMesh);
+        out.push_back(std::move(subMesh));
+        return;
+      } catch(const std::runtime_error &e) {
+        if(tris.size() < 2)throw;
+      }
+    }
+
+    // split at the median triangle center along the longest axis
+    Vec3 min{verts[indices[tris[0]*3]]};
+    Vec3 max{min};
+    auto center = [&](uint32_t t) {
+      return (verts[indices[t*3]] + verts[indices[t*3+1]] + verts[indices[t*3+2]]) * (1.0f / 3.0f);
+    };
+    for(uint32_t t : tris) {
+      auto c = center(t);
+      for(int i=0; i<3; ++i) {
+        min[i] = fminf(min[i], c[i]);
+        max[i] = fmaxf(max[i], c[i]);
+      }
+    }
+    Vec3 size = max - min;
+    int axis = (size[0] >= size[1] && size[0] >= size[2]) ? 0 : (size[1] >= size[2] ? 1 : 2);
+
+    auto mid = tris.begin() + tris.size() / 2;
+    std::nth_element(tris.begin(), mid, tris.end(), [&](uint32_t a, uint32_t b) {
+      return center(a)[axis] < center(b)[axis];
+    });
+
+    std::vector<uint32_t> trisA{tris.begin(), mid};
+    std::vector<uint32_t> trisB{mid, tris.end()};
+    buildSubMeshes(trisA, verts, indices, normals, bvhConfig, out);
+    buildSubMeshes(trisB, verts, indices, normals, bvhConfig, out);
+  }
+}
+
+void convertColl(const char* gltfPath, const char* collPath)
 {
-  const char* gltfPath = argv[1];
-  const char* collPath = argv[2];
-  fs::path gltfBasePath{argv[1]};
+  fs::path gltfBasePath{gltfPath};
   gltfBasePath = gltfBasePath.parent_path();
 
   cgltf_options options{};
@@ -75,16 +333,18 @@ int main(int argc, char** argv)
   if(result == cgltf_result_file_not_found) {
     throw std::runtime_error("File not found!");
   }
-  if(cgltf_validate(data) != cgltf_result_success) {
+  if(result != cgltf_result_success || cgltf_validate(data) != cgltf_result_success) {
+    cgltf_free(data);
     throw std::runtime_error("Invalid glTF data!");
   }
 
-  cgltf_load_buffers(&options, data, gltfPath);
+  std::unique_ptr<cgltf_data, decltype(&cgltf_free)> dataGuard{data, cgltf_free};
+  if(cgltf_load_buffers(&options, data, gltfPath) != cgltf_result_success) {
+    throw std::runtime_error("Failed to load glTF buffers!");
+  }
 
   std::vector<Vec3> verticesFloat{};
-  std::vector<IVec3> vertices{};
-  std::vector<IVec3> normals{};
-  std::vector<uint16_t> indices{};
+  std::vector<uint32_t> indices{};
 
   for(int i=0; i<data->nodes_count; ++i)
   {
@@ -102,9 +362,7 @@ int main(int argc, char** argv)
 
     for(int j = 0; j < mesh->primitives_count; j++)
     {
-      int baseIndex = vertices.size();
-      assert(baseIndex < 0x10000);
-
+      uint32_t baseIndex = verticesFloat.size();
       auto prim = &mesh->primitives[j];
 
       // Read indices
@@ -130,14 +388,7 @@ int main(int argc, char** argv)
           assert(attr->data->type == cgltf_type_vec3);
           for(int l = 0; l < acc->count; l++) {
             auto vert = Gltf::readAsVec3(basePtr, attr->data->type, acc->component_type);
-            vert = nodeMat * vert;
-
-            verticesFloat.push_back(vert);
-            vertices.push_back({
-              (int16_t)(vert[0] * BASE_SCALE),
-              (int16_t)(vert[1] * BASE_SCALE),
-              (int16_t)(vert[2] * BASE_SCALE)
-            });
+            verticesFloat.push_back(nodeMat * vert);
           }
         }
       }
@@ -145,7 +396,13 @@ int main(int argc, char** argv)
     } // primitives
   } // nodes
 
+  assert(indices.size() % 3 == 0);
+  if(indices.empty()) {
+    throw std::runtime_error("No collision meshes found (node names must contain 'coll_')");
+  }
+
   // generate normals
+  std::vector<IVec3> normals{};
   for(int v=0; v<indices.size(); v+=3) {
     Vec3 edge1 = verticesFloat[indices[v+1]] - verticesFloat[indices[v]];
     Vec3 edge2 = verticesFloat[indices[v+2]] - verticesFloat[indices[v]];
@@ -170,37 +427,90 @@ int main(int argc, char** argv)
     });
   }
 
-  assert(indices.size() % 3 == 0);
+  // merge vertices shared between primitives and nodes, then drop triangles that collapsed
+  auto weldMap = weldVertices(verticesFloat, WELD_TOLERANCE);
+  std::vector<uint32_t> tris{};
+  uint32_t collapsedCount = 0;
+  for(uint32_t t=0; t<indices.size()/3; ++t) {
+    uint32_t a = weldMap[indices[t*3]];
+    uint32_t b = weldMap[indices[t*3+1]];
+    uint32_t c = weldMap[indices[t*3+2]];
+    if(a == b || b == c || c == a) {
+      ++collapsedCount;
+      continue;
+    }
+    indices[t*3] = a;
+    indices[t*3+1] = b;
+    indices[t*3+2] = c;
+    tris.push_back(t);
+  }
 
-  printf("Vert/Index count: %d %d\n", vertices.size(), indices.size());
+  std::vector<SubMesh> subMeshes{};
+  buildSubMeshes(tris, verticesFloat, indices, normals, getBVHConfig(), subMeshes);
 
-  auto bvh = createMeshBVH(vertices, indices);
+  uint32_t weldedCount = 0;
+  for(auto &m : subMeshes)weldedCount += m.verts.size();
+  printf("%s: Vert/Index count: %d %d, welded to %d verts, %d collapsed tris, %d sub-mesh(es)\n",
+    gltfPath, (int)verticesFloat.size(), (int)indices.size(), (int)weldedCount, (int)collapsedCount, (int)subMeshes.size()
+  );
+  for(size_t m=0; m<subMeshes.size(); ++m) {
+    printBVHStats(gltfPath, (int)m, subMeshes[m].bvhStats);
+  }
 
+  // sub-meshes are stored back to back, each header points to the next one (relative offset, 0 for the last)
   BinaryFile file{};
-  file.write<uint32_t>(indices.size() / 3);
-  file.write<uint32_t>(vertices.size());
-  file.write<float>(1.0f / BASE_SCALE);
-  file.write<uint32_t>(0); // vertex pointer
-  file.write<uint32_t>(0); // normals pointer
-  file.write<uint32_t>(0); // BVH pointer
-
-  file.writeArray(indices.data(), indices.size());
-  file.align(4);
-
-  for(auto& n : normals) {
-    file.writeArray(n.pos, 3);
-  }
-  file.align(4);
+  for(size_t m=0; m<subMeshes.size(); ++m)
+  {
+    auto &subMesh = subMeshes[m];
+    BinaryFile body{};
+    body.writeArray(subMesh.indices.data(), subMesh.indices.size());
+    body.align(4);
 
-  for(auto& v : verticesFloat) {
-    file.writeArray(v.data, 3);
-  }
-  file.align(4);
+    for(auto& n : subMesh.normals) {
+      body.writeArray(n.pos, 3);
+    }
+    body.align(4);
 
-  file.writeArray(bvh.data(), bvh.size());
-  file.align(4);
+    for(auto& v : subMesh.verts) {
+      body.writeArray(v.data, 3);
+    }
+    body.align(4);
+
+    body.writeArray(subMesh.bvh.data(), subMesh.bvh.size());
+    body.align(4);
+
+    // optional, relative offset to it is stored in the header
+    uint32_t triDataOffset = 0;
+    if(!subMesh.triData.empty()) {
+      triDataOffset = HEADER_SIZE + body.getSize();
+      for(auto &tri : subMesh.triData) {
+        body.writeArray(tri.normal, 3);
+        body.write(tri.planeDist);
+        body.writeArray(tri.baryCoeff, 3);
+        body.writeArray(tri.edgeInvLen2, 3);
+        body.write(tri.type);
+      }
+    }
+    body.align(SUB_MESH_ALIGN);
+
+    bool isLast = (m+1) == subMeshes.size();
+    file.write<uint32_t>(subMesh.indices.size() / 3);
+    file.write<uint32_t>(subMesh.verts.size());
+    file.write<float>(1.0f / BASE_SCALE);
+    file.write<uint32_t>(0); // vertex pointer
+    file.write<uint32_t>(0); // normals pointer
+    file.write<uint32_t>(0); // BVH pointer
+    file.write<uint32_t>(isLast ? 0 : (HEADER_SIZE + body.getSize())); // next sub-mesh
+    file.write<uint32_t>(triDataOffset); // triangle data pointer
+    file.writeMemFile(body);
+  }
 
   file.writeToFile(collPath);
 }
 
+int main(int argc, char** argv)
+{
+  return Batch::run(argc, argv, FORMAT_VERSION, convertColl);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,112 @@
+/**
+* @copyright 2024 - Max Bebök
+* @license MIT
+*/
+#ifndef N64
+
+#include "lib/lodepng.h"
+#include "binaryFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace {
+  // must match the runtime (scene/actors/grass.cpp)
+  constexpr uint32_t MAX_BLADES = 64*10;
+  constexpr int BLADE_SPACING = 3;
+  constexpr int8_t BLADE_POS_Y = 1;
+  constexpr int8_t BLADE_SIZE = 120;
+  constexpr uint8_t BLADE_COLOR_MUL = 230;
+  constexpr uint8_t MIN_ALPHA = 64;
+
+  struct Blade {
+    int8_t pos[3]{};
+    uint8_t color[4]{};
+  };
+
+  std::vector<Blade> parseHeightmap(const std::vector<uint8_t> &pixels, int width, int height)
+  {
+    std::vector<Blade> res{};
+    for(int z=0; z<height; ++z) {
+      for(int x=0; x<width; ++x) {
+        if(res.size() >= MAX_BLADES)return res;
+
+        const uint8_t *px = &pixels[(z * width + x) * 4];
+        if(px[3] < MIN_ALPHA)continue;
+
+        Blade blade{};
+        blade.pos[0] = (int8_t)((x - width/2) * BLADE_SPACING);
+        blade.pos[1] = BLADE_POS_Y;
+        blade.pos[2] = (int8_t)((z - height/2) * -BLADE_SPACING);
+        for(int i=0; i<3; ++i)blade.color[i] = (uint8_t)(px[i] * BLADE_COLOR_MUL / 255);
+        blade.color[3] = px[3] >> 1;
+        res.push_back(blade);
+      }
+    }
+    return res;
+  }
+
+  /**
+   * Layout: uint32 blade count (even), followed by the blades in the tpx buffer format.
+   * Each 'TPXParticle' holds two blades: posA, sizeA, posB, sizeB, colorA, colorB.
+   */
+  void writeGrass(const std::vector<Blade> &blades, const char* outPath)
+  {
+    uint32_t count = blades.size() & ~1u;
+    BinaryFile file{};
+    file.write<uint32_t>(count);
+
+    for(uint32_t i=0; i<count; i+=2) {
+      for(int b=0; b<2; ++b) {
+        file.writeArray(blades[i+b].pos, 3);
+        file.write<int8_t>(BLADE_SIZE);
+      }
+      for(int b=0; b<2; ++b) {
+        file.writeArray(blades[i+b].color, 4);
+      }
+    }
+    file.writeToFile(outPath);
+  }
+
+  bool convertGrass(const char* pngPath, const char* outPath)
+  {
+    std::vector<uint8_t> pixels{};
+    unsigned width, height;
+    auto error = lodepng::decode(pixels, width, height, pngPath, LCT_RGBA, 8);
+    if(error) {
+      fprintf(stderr, "Error: %s: %s\n", pngPath, lodepng_error_text(error));
+      return false;
+    }
+
+    auto blades = parseHeightmap(pixels, (int)width, (int)height);
+    writeGrass(blades, outPath);
+    printf("%s: %d blades\n", outPath, (int)(blades.size() & ~1u));
+    return true;
+  }
+}
+
+/**
+ * Bakes grass heightmaps into particle buffers, which the game loads as-is.
+ * Pixels with enough alpha become a blade, positions follow the pixel grid.
+ * The per-instance random offset is still applied at runtime.
+ *
+ *   png_to_grass <in.png> <out.grass> [<in.png> <out.grass> ...]
+ */
+int main(int argc, char** argv)
+{
+  if(argc < 3 || (argc % 2) == 0) {
+    fprintf(stderr, "Usage: %s <in.png> <out.grass> [<in.png> <out.grass> ...]\n", argv[0]);
+    return 1;
+  }
+
+  int failed = 0;
+  for(int i=1; i+1<argc; i+=2) {
+    if(!convertGrass(argv[i], argv[i+1]))++failed;
+  }
+  return failed > 0 ? 1 : 0;
+}
+
+#endif
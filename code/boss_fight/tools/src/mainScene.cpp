@@ -10,6 +10,7 @@ namespace {
 }
 
 #include "cgltfHelper.h"
+#include "batch.h"
 
 #define CGLTF_IMPLEMENTATION
 #include "lib/cgltf.h"
@@ -19,6 +20,7 @@ namespace {
 #include <string>
 #include <vector>
 #include <filesystem>
+#include <memory>
 
 namespace fs = std::filesystem;
 
@@ -72,11 +74,14 @@ namespace {
   }
 }
 
-int main(int argc, char** argv)
+namespace {
+  // bump whenever the output format changes, so cached outputs get rebuilt
+  constexpr const char* FORMAT_VERSION = "scene-1";
+}
+
+void convertScene(const char* gltfPath, const char* scenePath)
 {
-  const char* gltfPath = argv[1];
-  const char* scenePath = argv[2];
-  fs::path gltfBasePath{argv[1]};
+  fs::path gltfBasePath{gltfPath};
   gltfBasePath = gltfBasePath.parent_path();
 
   cgltf_options options{};
@@ -86,11 +91,15 @@ int main(int argc, char** argv)
   if(result == cgltf_result_file_not_found) {
     throw std::runtime_error("File not found!");
   }
-  if(cgltf_validate(data) != cgltf_result_success) {
+  if(result != cgltf_result_success || cgltf_validate(data) != cgltf_result_success) {
+    cgltf_free(data);
     throw std::runtime_error("Invalid glTF data!");
   }
 
-  cgltf_load_buffers(&options, data, gltfPath);
+  std::unique_ptr<cgltf_data, decltype(&cgltf_free)> dataGuard{data, cgltf_free};
+  if(cgltf_load_buffers(&options, data, gltfPath) != cgltf_result_success) {
+    throw std::runtime_error("Failed to load glTF buffers!");
+  }
 
   auto actors = parseActors(data);
   BinaryFile sceneFile{};
@@ -105,4 +114,9 @@ int main(int argc, char** argv)
   sceneFile.writeToFile(scenePath);
 }
 
+int main(int argc, char** argv)
+{
+  return Batch::run(argc, argv, FORMAT_VERSION, convertScene);
+}
+
 #endif
\ No newline at end of file
@@ -4,7 +4,7 @@
 */
 #ifndef N64
 
-#include "vec.h"
+#include "meshBVH.h"
 #include "bvh/v2/bvh.h"
 #include "bvh/v2/vec.h"
 #include "bvh/v2/ray.h"
@@ -12,6 +12,8 @@
 #include "bvh/v2/default_builder.h"
 
 #include <vector>
+#include <stdexcept>
+#include <algorithm>
 
 using Scalar  = double;
 using BVec3   = bvh::v2::Vec<Scalar, 3>;
@@ -21,72 +23,231 @@ using Bvh     = bvh::v2::Bvh<Node>;
 
 namespace
 {
-  void writeBVHNode(std::vector<int16_t> &out, Node &node, int nodeIndex) {
+  // must match the runtime (collision/bvh.h)
+  constexpr int16_t BVH_FLAG_WIDE = 1 << 0;
+  constexpr int BVH_STACK_SIZE = 64;
+
+  BBox toIntBounds(const Node &node) {
     // 'bounds' layout is [min_x, max_x, min_y, max_y, min_z, max_z]
-    // we need min/max as separate vectors
     int16_t offset = 1;
-
-    IVec3 min{
-      (int16_t)round(node.bounds[0]) - offset,
-      (int16_t)round(node.bounds[2]) - offset,
-      (int16_t)round(node.bounds[4]) - offset
-    };
-    IVec3 max{
-      (int16_t)round(node.bounds[1]) + offset,
-      (int16_t)round(node.bounds[3]) + offset,
-      (int16_t)round(node.bounds[5]) + offset
+    BBox res{
+      BVec3{round(node.bounds[0]) - offset, round(node.bounds[2]) - offset, round(node.bounds[4]) - offset},
+      BVec3{round(node.bounds[1]) + offset, round(node.bounds[3]) + offset, round(node.bounds[5]) + offset}
     };
 
     for(int i=0; i<3; ++i) {
-      int diff = max.pos[i] - min.pos[i];
-      if(diff < 8) {
-        min.pos[i] -= 4;
-        max.pos[i] += 4;
+      if(res.max[i] - res.min[i] < 8) {
+        res.min[i] -= 4;
+        res.max[i] += 4;
       }
     }
+    return res;
+  }
+
+  void writeAABB(std::vector<int16_t> &out, const BBox &box) {
+    for(int i=0; i<3; ++i)out.push_back((int16_t)box.min[i]);
+    for(int i=0; i<3; ++i)out.push_back((int16_t)box.max[i]);
+  }
+
+  int16_t packLeaf(const Node &node, int maxFirstId) {
+    int dataCount = node.index.prim_count();
+    int dataOffset = node.index.first_id();
+    if(dataCount > 0b1111) {
+      printf("Error: leaf with %d triangles, max. is 15\n", dataCount);
+      throw std::runtime_error("BVH leaf too large");
+    }
+    if(dataOffset > maxFirstId) {
+      printf("Error: leaf triangle offset %d does not fit in 12 bits\n", dataOffset);
+      throw std::runtime_error("BVH leaf offset out of range");
+    }
+    return (int16_t)((dataOffset << 4) | dataCount);
+  }
+
+  int16_t packInner(int childIndex, int nodeIndex, int minDiff, int maxDiff) {
+    int indexDiff = childIndex - nodeIndex;
+    if(indexDiff < minDiff || indexDiff > maxDiff) {
+      printf("Error: indexDiff %d (%d - %d) does not fit in 12 bits\n", indexDiff, childIndex, nodeIndex);
+      throw std::runtime_error("BVH node offset out of range");
+    }
+    return (int16_t)(indexDiff << 4);
+  }
+
+  int getDepth(const Bvh &bvh, const Node &node) {
+    if(node.is_leaf())return 1;
+    return 1 + std::max(
+      getDepth(bvh, bvh.nodes[node.index.first_id()]),
+      getDepth(bvh, bvh.nodes[node.index.first_id() + 1])
+    );
+  }
 
-    for(auto p : min.pos)out.push_back(p);
-    for(auto p : max.pos)out.push_back(p);
+  double getOverlapArea(const BBox &a, const BBox &b) {
+    BBox overlap{BVec3{
+      std::max(a.min[0], b.min[0]), std::max(a.min[1], b.min[1]), std::max(a.min[2], b.min[2])
+    }, BVec3{
+      std::min(a.max[0], b.max[0]), std::min(a.max[1], b.max[1]), std::min(a.max[2], b.max[2])
+    }};
+    for(int i=0; i<3; ++i) {
+      if(overlap.min[i] > overlap.max[i])return 0.0;
+    }
+    return overlap.get_half_area();
+  }
 
-    int dataCount = node.index.value & 0b1111;
-    int dataOffset = node.index.value >> 4;
+  MeshBVHStats getStats(const Bvh &bvh, double nodeCost) {
+    MeshBVHStats stats{};
+    stats.nodeCount = bvh.nodes.size();
+    stats.depth = getDepth(bvh, bvh.get_root());
 
-    if(dataCount == 0) {
-      int indexDiff = dataOffset - nodeIndex;
+    double rootArea = bvh.get_root().get_bbox().get_half_area();
+    double innerCount = 0;
+    for(auto &node : bvh.nodes) {
+      double area = node.get_bbox().get_half_area() / rootArea;
+      if(node.is_leaf()) {
+        ++stats.leafCount;
+        ++stats.leafSizes[std::min<size_t>(node.index.prim_count(), 15)];
+        stats.sahCost += area * node.index.prim_count();
+        continue;
+      }
 
-      int16_t packedVal = (int16_t)(indexDiff << 4);
-      if((packedVal >> 4) != indexDiff) {
-        printf("Error: indexDiff %d (%d - %d) does not fit in 12 bits\n", indexDiff, dataOffset, nodeIndex);
-        throw;
+      ++innerCount;
+      stats.sahCost += area * nodeCost;
+      double parentArea = node.get_bbox().get_half_area();
+      if(parentArea > 0.0) {
+        stats.overlap += getOverlapArea(
+          bvh.nodes[node.index.first_id()].get_bbox(),
+          bvh.nodes[node.index.first_id() + 1].get_bbox()
+        ) / parentArea;
       }
-      //assert((packedVal >> 4) == indexDiff);
-      out.push_back(packedVal);
-    } else {
-      out.push_back(node.index.value);
     }
+    if(innerCount > 0)stats.overlap /= innerCount;
+    return stats;
   }
 
-  void writeBVH(std::vector<int16_t> &out, Bvh &bvh) {
-    out.push_back(bvh.nodes.size());
-    out.push_back(bvh.prim_ids.size());
+  /**
+   * Binary layout, 7 int16 per node: AABB + packed value.
+   * Inner nodes store the (signed) offset to their first child, leaves their first triangle.
+   */
+  void writeBVHBinary(std::vector<int16_t> &out, Bvh &bvh) {
     int nodeIndex = 0;
     for(auto& node : bvh.nodes) {
-      writeBVHNode(out, node, nodeIndex++);
+      writeAABB(out, toIntBounds(node));
+      if(node.is_leaf()) {
+        out.push_back(packLeaf(node, 0x7FF));
+      } else {
+        out.push_back(packInner(node.index.first_id(), nodeIndex, -0x800, 0x7FF));
+      }
+      ++nodeIndex;
     }
-    for(auto&& prim_id : bvh.prim_ids) {
-      out.push_back(prim_id);
+  }
+
+  /**
+   * Wide layout, 28 int16 per node: 4 child AABBs followed by 4 packed values.
+   * Built by collapsing the binary tree, always opening up the inner child with the largest area.
+   * Unused slots get an inverted AABB that never passes a test.
+   */
+  uint32_t writeBVHWide(std::vector<int16_t> &out, Bvh &bvh) {
+    std::vector<std::vector<size_t>> wideNodes{};
+    std::vector<size_t> queue{0};
+
+    // collect children of each wide node in breadth-first order
+    for(size_t q=0; q<queue.size(); ++q) {
+      auto &root = bvh.nodes[queue[q]];
+      std::vector<size_t> children{};
+      if(root.is_leaf()) {
+        children.push_back(queue[q]); // single leaf as the whole tree
+      } else {
+        children = {root.index.first_id(), root.index.first_id() + 1};
+      }
+
+      while(children.size() < 4) {
+        int best = -1;
+        double bestArea = -1.0;
+        for(size_t c=0; c<children.size(); ++c) {
+          auto &child = bvh.nodes[children[c]];
+          if(child.is_leaf())continue;
+          double area = child.get_bbox().get_half_area();
+          if(area > bestArea) {
+            bestArea = area;
+            best = (int)c;
+          }
+        }
+        if(best < 0)break;
+        size_t first = bvh.nodes[children[best]].index.first_id();
+        children[best] = first;
+        children.insert(children.begin() + best + 1, first + 1);
+      }
+
+      for(auto c : children) {
+        if(!bvh.nodes[c].is_leaf())queue.push_back(c);
+      }
+      wideNodes.push_back(children);
+    }
+
+    // queue order == output order, so inner children can be found by their position in it
+    std::vector<int> wideIndex(bvh.nodes.size(), -1);
+    for(size_t q=0; q<queue.size(); ++q)wideIndex[queue[q]] = (int)q;
+
+    for(size_t n=0; n<wideNodes.size(); ++n) {
+      auto &children = wideNodes[n];
+      for(int c=0; c<4; ++c) {
+        if(c < children.size()) {
+          writeAABB(out, toIntBounds(bvh.nodes[children[c]]));
+        } else {
+          for(int i=0; i<3; ++i)out.push_back(0x7FFF);
+          for(int i=0; i<3; ++i)out.push_back(-0x8000);
+        }
+      }
+      for(int c=0; c<4; ++c) {
+        if(c >= children.size()) {
+          out.push_back(0);
+          continue;
+        }
+        auto &child = bvh.nodes[children[c]];
+        if(child.is_leaf()) {
+          out.push_back(packLeaf(child, 0xFFF));
+        } else {
+          out.push_back(packInner(wideIndex[children[c]], (int)n, 1, 0xFFF));
+        }
+      }
+    }
+    return wideNodes.size();
+  }
+
+  // @return node count of the written layout
+  uint32_t writeBVH(std::vector<int16_t> &out, Bvh &bvh, bool wide) {
+    int depth = getDepth(bvh, bvh.get_root());
+    int stackSize = wide ? (depth * 3 + 1) : (depth + 1);
+    if(stackSize > BVH_STACK_SIZE) {
+      printf("Error: BVH depth %d needs a traversal stack of %d entries (max. %d)\n", depth, stackSize, BVH_STACK_SIZE);
+      throw std::runtime_error("BVH too deep");
     }
+
+    std::vector<int16_t> nodeData{};
+    uint32_t nodeCount = wide ? writeBVHWide(nodeData, bvh) : bvh.nodes.size();
+    if(!wide)writeBVHBinary(nodeData, bvh);
+
+    out.push_back(nodeCount);
+    out.push_back(wide ? BVH_FLAG_WIDE : 0);
+    out.insert(out.end(), nodeData.begin(), nodeData.end());
+    return nodeCount;
   }
 }
 
 /**
  * Creates a BVH of all object AABBs
- * The result is a list of 16bit ints encoding both nodes, indices and AABB extends
- * @param modelChunks
+ * The result is a list of 16bit ints encoding both nodes and AABB extends.
+ * Leaves store a range of triangles, which is only valid after reordering them as in 'primOrder'.
+ * @param vertices triangle vertices, in the same int16 space as the AABBs
+ * @param indices 3 per triangle
+ * @param config builder settings and output layout
+ * @param primOrder receives the new order of the triangles (leaf order)
+ * @param stats receives a quality report of the tree
  */
 std::vector<int16_t> createMeshBVH(
   const std::vector<IVec3> &vertices,
-  const std::vector<uint16_t> &indices
+  const std::vector<uint16_t> &indices,
+  const MeshBVHConfig &config,
+  std::vector<uint32_t> &primOrder,
+  MeshBVHStats &stats
 ) {
   std::vector<BBox> aabbs;
   std::vector<BVec3> centers;
@@ -104,14 +265,24 @@ std::vector<int16_t> createMeshBVH(
     centers.push_back(aabb.get_center());
   }
 
+  using Builder = bvh::v2::DefaultBuilder<Node>;
+  constexpr Builder::Quality QUALITIES[3]{Builder::Quality::Low, Builder::Quality::Medium, Builder::Quality::High};
+
   bvh::v2::ThreadPool thread_pool;
-  typename bvh::v2::DefaultBuilder<Node>::Config config;
-  config.quality = bvh::v2::DefaultBuilder<Node>::Quality::High;
-  auto bvh = bvh::v2::DefaultBuilder<Node>::build(thread_pool, aabbs, centers, config);
+  typename Builder::Config builderConfig;
+  builderConfig.quality = QUALITIES[config.quality];
+  builderConfig.min_leaf_size = config.minLeafSize;
+  builderConfig.max_leaf_size = config.maxLeafSize;
+  builderConfig.sah = bvh::v2::SplitHeuristic<Scalar>{0, config.nodeCost};
+  auto bvh = Builder::build(thread_pool, aabbs, centers, builderConfig);
 
   std::vector<int16_t> treeData;
-  writeBVH(treeData, bvh);
+  uint32_t wideNodeCount = writeBVH(treeData, bvh, config.wide);
+  primOrder.assign(bvh.prim_ids.begin(), bvh.prim_ids.end());
+
+  stats = getStats(bvh, config.nodeCost);
+  if(config.wide)stats.wideNodeCount = wideNodeCount;
   return treeData;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,36 @@
+/**
+* @copyright 2024 - Max Bebök
+* @license MIT
+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "vec.h"
+
+struct MeshBVHConfig {
+  bool wide{false}; // 4 children per node instead of 2
+  int quality{2}; // 0-2, low/medium/high of bvh::v2::DefaultBuilder
+  int minLeafSize{1};
+  int maxLeafSize{8}; // at most 15, leaves store their triangle count in 4 bits
+  double nodeCost{1.0}; // cost of a node test relative to a triangle test, higher values make larger leaves
+};
+
+// quality of the (binary) tree before it is written out
+struct MeshBVHStats {
+  uint32_t nodeCount{};
+  uint32_t leafCount{};
+  uint32_t depth{};
+  uint32_t leafSizes[16]{}; // histogram, indexed by triangle count
+  double sahCost{}; // relative to the root, using the configured node cost
+  double overlap{}; // average overlap of two siblings, relative to their parent (surface area)
+  uint32_t wideNodeCount{}; // only set for the wide layout
+};
+
+std::vector<int16_t> createMeshBVH(
+  const std::vector<IVec3> &vertices,
+  const std::vector<uint16_t> &indices,
+  const MeshBVHConfig &config,
+  std::vector<uint32_t> &primOrder,
+  MeshBVHStats &stats
+);
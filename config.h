@@ -25,6 +25,19 @@
     // The current minigame you want to test
     #define MINIGAME_TO_TEST  "examplegame"
 
+    // Record how long each phase of every frame takes, and dump it as CSV to the debug log when a level ends.
+    // This waits for the RDP at the end of every frame, so it slightly changes the performance it measures
+    #define PROFILE_LEVELS  0
+
+    // Tag every allocation made by the minigames with the file and line it came from, so that memory
+    // leaks found when a minigame ends can be listed by caller. Heap totals are always reported regardless
+    #define HEAP_TRACKING  0
+
+    // Record the inputs of every frame to REPLAY_FILE (REPLAY_RECORD), or play them back from it (REPLAY_PLAY).
+    // Use a path starting with "sd:/" to use a flashcart's SD card, or "rom:/" to play back a replay shipped in the filesystem folder
+    #define REPLAY_MODE  REPLAY_OFF
+    #define REPLAY_FILE  "sd:/replay.nbr"
+
     // Initialize USB and isViewer logging
     #if defined(DEBUG) && DEBUG == 1
         #define DEBUG_LOG 1
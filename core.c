@@ -17,6 +17,14 @@ player, AI, and game loop information.
 #include "title.h"
 
 
+/*********************************
+           Definitions
+*********************************/
+
+// The number of frames the profiler remembers
+#define PROFILE_FRAMECOUNT  256
+
+
 /*********************************
             Structures
 *********************************/
@@ -25,6 +33,16 @@ typedef struct {
     joypad_port_t port;
 } Player;
 
+typedef struct {
+    const char* level;
+    uint32_t frame;
+    uint32_t fixedcount;
+    uint32_t fixedloop;
+    uint32_t loop;
+    uint32_t rdp;
+    uint32_t total;
+} ProfileFrame;
+
 
 /*********************************
              Globals
@@ -50,6 +68,18 @@ static Level global_core_alllevels[LEVELCOUNT];
 // Game info
 static NextRound global_nextroundtype = NR_LEAST;
 
+// Level names, for the profiler
+static const char* global_core_levelnames[LEVELCOUNT] = {"loadsave", "mainmenu", "gamesetup", "minigameselect", NULL, "results"};
+
+// Profiler info, times are kept in ticks
+static ProfileFrame global_core_profile_cur;
+static uint32_t     global_core_profile_framestart;
+#if PROFILE_LEVELS
+    static ProfileFrame global_core_profile[PROFILE_FRAMECOUNT];
+    static uint32_t     global_core_profile_count = 0;
+    static uint32_t     global_core_profile_levelstart = 0;
+#endif
+
 
 /*==============================
     core_get_subtick
@@ -271,9 +301,20 @@ void core_level_doinit()
     }
 
     if (global_core_curlevel == &global_core_alllevels[LEVEL_MINIGAME])
+    {
         core_reset_winners();
+        heapstats_begin(minigame_get_game()->internalname);
+    }
     if (global_core_curlevel->funcPointer_init)
         global_core_curlevel->funcPointer_init();
+    heapstats_sample();
+
+    // Start profiling the level from here, so that the init isn't counted as part of the first frame
+    memset(&global_core_profile_cur, 0, sizeof(ProfileFrame));
+    global_core_profile_framestart = TICKS_READ();
+    #if PROFILE_LEVELS
+        global_core_profile_levelstart = global_core_profile_count;
+    #endif
 }
 
 
@@ -285,8 +326,10 @@ void core_level_doinit()
 
 void core_level_doloop(float deltatime)
 {
+    uint32_t start = TICKS_READ();
     if (global_core_curlevel->funcPointer_loop)
         global_core_curlevel->funcPointer_loop(deltatime);
+    global_core_profile_cur.loop += TICKS_DISTANCE(start, TICKS_READ());
 }
 
 
@@ -298,8 +341,94 @@ void core_level_doloop(float deltatime)
 
 void core_level_dofixedloop(float deltatime)
 {
+    uint32_t start = TICKS_READ();
     if (global_core_curlevel->funcPointer_fixedloop)
         global_core_curlevel->funcPointer_fixedloop(deltatime);
+    global_core_profile_cur.fixedloop += TICKS_DISTANCE(start, TICKS_READ());
+    global_core_profile_cur.fixedcount++;
+}
+
+
+/*==============================
+    core_level_endframe
+    Marks the end of a frame for the profiler and the heap
+    stats. When PROFILE_LEVELS is enabled, this waits for the
+    RSP and RDP to finish the frame's commands and records the
+    frame's timings
+==============================*/
+
+void core_level_endframe()
+{
+    #if PROFILE_LEVELS
+        uint32_t start = TICKS_READ();
+        uint32_t end;
+        rspq_wait();
+        end = TICKS_READ();
+        global_core_profile_cur.rdp = TICKS_DISTANCE(start, end);
+        global_core_profile_cur.total = TICKS_DISTANCE(global_core_profile_framestart, end);
+        global_core_profile_cur.level = core_level_getname();
+        global_core_profile_cur.frame = global_core_profile_count - global_core_profile_levelstart;
+        global_core_profile[global_core_profile_count % PROFILE_FRAMECOUNT] = global_core_profile_cur;
+        global_core_profile_count++;
+        global_core_profile_framestart = end;
+    #endif
+    memset(&global_core_profile_cur, 0, sizeof(ProfileFrame));
+    heapstats_sample();
+}
+
+
+/*==============================
+    core_level_getname
+    Gets the name of the current level. For minigames, this is
+    the minigame's internal name
+    @return The level name
+==============================*/
+
+const char* core_level_getname()
+{
+    if (global_core_curlevel == &global_core_alllevels[LEVEL_MINIGAME])
+        return minigame_get_game()->internalname;
+    return global_core_levelnames[global_core_curlevel - global_core_alllevels];
+}
+
+
+/*==============================
+    core_profile_dump
+    Prints the frames the profiler remembers for the current
+    level to the debug log, as CSV
+==============================*/
+
+void core_profile_dump()
+{
+    #if PROFILE_LEVELS
+        uint32_t first = global_core_profile_levelstart;
+        uint32_t maxloop = 0, maxtotal = 0;
+        uint64_t sumloop = 0, sumtotal = 0;
+        if (global_core_profile_count - first > PROFILE_FRAMECOUNT)
+            first = global_core_profile_count - PROFILE_FRAMECOUNT;
+        if (first == global_core_profile_count)
+            return;
+
+        debugf("level,frame,fixedloop_count,fixedloop_us,loop_us,rdp_us,frame_us\n");
+        for (uint32_t i=first; i<global_core_profile_count; i++)
+        {
+            ProfileFrame* f = &global_core_profile[i % PROFILE_FRAMECOUNT];
+            debugf("%s,%lu,%lu,%lu,%lu,%lu,%lu\n", f->level, f->frame, f->fixedcount, 
+                TICKS_TO_US(f->fixedloop), TICKS_TO_US(f->loop), TICKS_TO_US(f->rdp), TICKS_TO_US(f->total)
+            );
+            sumloop += f->fixedloop + f->loop;
+            sumtotal += f->total;
+            if (f->fixedloop + f->loop > maxloop)
+                maxloop = f->fixedloop + f->loop;
+            if (f->total > maxtotal)
+                maxtotal = f->total;
+        }
+        debugf("# %s: %lu frames, cpu avg %llu us max %lu us, frame avg %llu us max %lu us\n", 
+            global_core_profile[first % PROFILE_FRAMECOUNT].level, global_core_profile_count - first,
+            TICKS_TO_US(sumloop/(global_core_profile_count - first)), TICKS_TO_US(maxloop),
+            TICKS_TO_US(sumtotal/(global_core_profile_count - first)), TICKS_TO_US(maxtotal)
+        );
+    #endif
 }
 
 
@@ -310,12 +439,16 @@ void core_level_dofixedloop(float deltatime)
 
 void core_level_docleanup()
 {
+    core_profile_dump();
     rspq_wait();
     for (int i=0; i<32; i++)
         mixer_ch_stop(i);
     //menu_copy_minigame_frame();
     if (global_core_curlevel->funcPointer_cleanup)
         global_core_curlevel->funcPointer_cleanup();
+
+    // Check the heap while the DSO is still loaded, so that it matches the state before the minigame's init
+    heapstats_end();
     if (global_core_curlevel == &global_core_alllevels[LEVEL_MINIGAME])
         minigame_cleanup();
     mixer_close();
@@ -129,6 +129,9 @@ extern "C" {
     extern void core_level_doloop(float deltatime);
     extern void core_level_dofixedloop(float deltatime);
     extern void core_level_docleanup();
+    extern void core_level_endframe();
+    extern const char* core_level_getname();
+    extern void core_profile_dump();
     extern bool core_level_waschanged();
 
     extern void core_set_playercount(bool* enabledconts);
@@ -146,4 +149,8 @@ extern "C" {
 }
 #endif
 
+// Every level reads the joypads through the replay system, and allocates through the heap tracker
+#include "replay.h"
+#include "heapstats.h"
+
 #endif
\ No newline at end of file
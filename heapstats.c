@@ -0,0 +1,359 @@
+/***************************************************************
+                           heapstats.c
+
+The file contains the heap accounting done around minigames.
+The core snapshots the heap when a minigame starts, samples it
+every frame to find the peak, and reports how much memory was
+left behind once the minigame is cleaned up, accumulated per
+minigame over the whole session.
+
+With HEAP_TRACKING enabled in config.h, every malloc, calloc,
+realloc and free made by code that includes core.h is also
+redirected here, so the allocations that are still alive after
+cleanup can be listed by the file and line that made them.
+Allocations made by libdragon itself, or through C++'s new, are
+only visible in the totals.
+***************************************************************/
+
+#define HEAPSTATS_NO_REDIRECT
+#include <libdragon.h>
+#include "core.h"
+#include "config.h"
+#include "heapstats.h"
+
+
+/*********************************
+           Definitions
+*********************************/
+
+// The number of minigames to keep totals for
+#define MAXHEAPSTATS     32
+
+// The number of live allocations that can be tracked at once, must be a power of two
+#define MAXALLOCATIONS   4096
+
+// The number of distinct callers listed in a leak report
+#define MAXLEAKCALLERS   16
+
+
+/*********************************
+            Structures
+*********************************/
+
+typedef struct {
+    const char* name;
+    uint32_t runs;
+    int peak;
+    int lastleak;
+    int totalleak;
+} HeapStats;
+
+typedef struct {
+    void* ptr;
+    size_t size;
+    const char* file;
+    int line;
+} Allocation;
+
+typedef struct {
+    const char* file;
+    int line;
+    uint32_t count;
+    size_t size;
+} LeakCaller;
+
+
+/*********************************
+             Globals
+*********************************/
+
+// Per minigame totals
+static HeapStats  global_heapstats[MAXHEAPSTATS];
+static HeapStats* global_heapstats_cur = NULL;
+static int        global_heapstats_start;
+
+// Live allocations, tagged by whether they were made while the current minigame was running
+#if HEAP_TRACKING
+    static Allocation global_heapstats_allocs[MAXALLOCATIONS];
+    static bool       global_heapstats_allocsingame[MAXALLOCATIONS];
+    static uint32_t   global_heapstats_alloccount = 0;
+    static uint32_t   global_heapstats_dropped = 0; // allocations not tracked since heapstats_begin, because the table was full
+    static bool       global_heapstats_warnedfull = false;
+#endif
+
+
+/*==============================
+    heapstats_used
+    Gets how many bytes of the heap are in use
+    @return The number of bytes in use
+==============================*/
+
+static int heapstats_used()
+{
+    heap_stats_t stats;
+    sys_get_heap_stats(&stats);
+    return stats.used;
+}
+
+
+/*==============================
+    heapstats_begin
+    Starts accounting the heap for a minigame
+    @param  The minigame's internal name
+==============================*/
+
+void heapstats_begin(const char* name)
+{
+    global_heapstats_cur = NULL;
+    for (int i=0; i<MAXHEAPSTATS; i++)
+    {
+        if (global_heapstats[i].name == NULL)
+            global_heapstats[i].name = name;
+        if (!strcmp(global_heapstats[i].name, name))
+        {
+            global_heapstats_cur = &global_heapstats[i];
+            break;
+        }
+    }
+    if (global_heapstats_cur == NULL)
+        return;
+
+    global_heapstats_start = heapstats_used();
+    #if HEAP_TRACKING
+        memset(global_heapstats_allocsingame, 0, sizeof(global_heapstats_allocsingame));
+        global_heapstats_dropped = 0;
+    #endif
+}
+
+
+/*==============================
+    heapstats_sample
+    Samples the heap usage, to keep track of the peak
+==============================*/
+
+void heapstats_sample()
+{
+    int used;
+    if (global_heapstats_cur == NULL)
+        return;
+    used = heapstats_used() - global_heapstats_start;
+    if (used > global_heapstats_cur->peak)
+        global_heapstats_cur->peak = used;
+}
+
+
+/*==============================
+    heapstats_end
+    Stops accounting the heap for the current minigame, and
+    reports what it left behind to the debug log
+==============================*/
+
+void heapstats_end()
+{
+    HeapStats* stats = global_heapstats_cur;
+    if (stats == NULL)
+        return;
+    global_heapstats_cur = NULL;
+
+    stats->runs++;
+    stats->lastleak = heapstats_used() - global_heapstats_start;
+    stats->totalleak += stats->lastleak;
+    debugf("Heap: %s peaked at %d bytes and left %d bytes behind (%d bytes over %ld runs)\n",
+        stats->name, stats->peak, stats->lastleak, stats->totalleak, (long)stats->runs
+    );
+    if (stats->runs == 1 && stats->lastleak > 0)
+        debugf("Heap: libdragon allocates some memory on first use, so check that this happens again on the next run\n");
+
+    // List the allocations made by the minigame which are still alive, grouped by caller
+    #if HEAP_TRACKING
+    {
+        LeakCaller callers[MAXLEAKCALLERS];
+        int callercount = 0;
+        memset(callers, 0, sizeof(callers));
+        for (int i=0; i<MAXALLOCATIONS; i++)
+        {
+            Allocation* alloc = &global_heapstats_allocs[i];
+            int j;
+            if (alloc->ptr == NULL || !global_heapstats_allocsingame[i])
+                continue;
+            for (j=0; j<callercount; j++)
+                if (callers[j].line == alloc->line && !strcmp(callers[j].file, alloc->file))
+                    break;
+            if (j == callercount)
+            {
+                if (callercount == MAXLEAKCALLERS)
+                    continue;
+                callers[callercount].file = alloc->file;
+                callers[callercount].line = alloc->line;
+                callercount++;
+            }
+            callers[j].count++;
+            callers[j].size += alloc->size;
+        }
+        for (int i=0; i<callercount; i++)
+            debugf("Heap:     %s:%d has %ld live allocations, %ld bytes\n", callers[i].file, callers[i].line, (long)callers[i].count, (long)callers[i].size);
+        if (global_heapstats_dropped > 0)
+            debugf("Heap:     tracking table full, %ld allocations were not tracked and can't be listed\n", (long)global_heapstats_dropped);
+    }
+    #endif
+}
+
+
+/*********************************
+        Allocation Tracking
+*********************************/
+
+#if HEAP_TRACKING
+
+/*==============================
+    heapstats_slot
+    Finds the tracking slot of a pointer. The table uses linear
+    probing, so the search ends at the first free slot
+    @param  The pointer to look for, or NULL to find a free slot
+    @param  The pointer to hash
+    @return The slot index, or -1 if not found
+==============================*/
+
+static int heapstats_slot(void* find, void* hash)
+{
+    uint32_t start = (((uintptr_t)hash) >> 3) & (MAXALLOCATIONS-1);
+    for (uint32_t i=0; i<MAXALLOCATIONS; i++)
+    {
+        uint32_t slot = (start + i) & (MAXALLOCATIONS-1);
+        if (global_heapstats_allocs[slot].ptr == find)
+            return slot;
+        if (global_heapstats_allocs[slot].ptr == NULL)
+            return -1;
+    }
+    return -1;
+}
+
+
+/*==============================
+    heapstats_insert
+    Adds an entry to the tracking table
+    @param  The allocation to add
+    @param  Whether it was made while a minigame was running
+==============================*/
+
+static void heapstats_insert(Allocation alloc, bool ingame)
+{
+    int slot;
+    if (global_heapstats_alloccount >= MAXALLOCATIONS/2)
+    {
+        if (!global_heapstats_warnedfull)
+            debugf("Heap: tracking table is full (%d allocations), further allocations won't be tracked\n", MAXALLOCATIONS/2);
+        global_heapstats_warnedfull = true;
+        global_heapstats_dropped++;
+        return;
+    }
+    slot = heapstats_slot(NULL, alloc.ptr);
+    global_heapstats_allocs[slot] = alloc;
+    global_heapstats_allocsingame[slot] = ingame;
+    global_heapstats_alloccount++;
+}
+
+
+/*==============================
+    heapstats_track
+    Starts tracking an allocation
+    @param  The allocated pointer
+    @param  The size of the allocation
+    @param  The file the allocation was made in
+    @param  The line the allocation was made in
+==============================*/
+
+static void heapstats_track(void* ptr, size_t size, const char* file, int line)
+{
+    if (ptr == NULL)
+        return;
+    heapstats_insert((Allocation){ptr, size, file, line}, global_heapstats_cur != NULL);
+}
+
+
+/*==============================
+    heapstats_untrack
+    Stops tracking an allocation. The table uses linear
+    probing, so the entries after it are reinserted
+    @param  The pointer that was freed
+    @param  Where to store the removed entry, can be NULL
+    @param  Where to store whether it was made in a minigame,
+            can be NULL
+    @return Whether the pointer was tracked
+==============================*/
+
+static bool heapstats_untrack(void* ptr, Allocation* removed, bool* removedingame)
+{
+    int slot;
+    if (ptr == NULL || (slot = heapstats_slot(ptr, ptr)) == -1)
+        return false;
+    if (removed != NULL)
+        *removed = global_heapstats_allocs[slot];
+    if (removedingame != NULL)
+        *removedingame = global_heapstats_allocsingame[slot];
+    global_heapstats_allocs[slot].ptr = NULL;
+    global_heapstats_alloccount--;
+    for (int i=(slot + 1) & (MAXALLOCATIONS-1); global_heapstats_allocs[i].ptr != NULL; i=(i + 1) & (MAXALLOCATIONS-1))
+    {
+        Allocation alloc = global_heapstats_allocs[i];
+        bool ingame = global_heapstats_allocsingame[i];
+        int newslot;
+        global_heapstats_allocs[i].ptr = NULL;
+        newslot = heapstats_slot(NULL, alloc.ptr);
+        global_heapstats_allocs[newslot] = alloc;
+        global_heapstats_allocsingame[newslot] = ingame;
+    }
+    return true;
+}
+
+#endif
+
+
+/*********************************
+       Allocation Redirects
+*********************************/
+
+void* heapstats_malloc(size_t size, const char* file, int line)
+{
+    void* ptr = malloc(size);
+    #if HEAP_TRACKING
+        heapstats_track(ptr, size, file, line);
+    #endif
+    return ptr;
+}
+
+void* heapstats_calloc(size_t count, size_t size, const char* file, int line)
+{
+    void* ptr = calloc(count, size);
+    #if HEAP_TRACKING
+        heapstats_track(ptr, count*size, file, line);
+    #endif
+    return ptr;
+}
+
+void* heapstats_realloc(void* ptr, size_t size, const char* file, int line)
+{
+    void* newptr;
+    #if HEAP_TRACKING
+        // The old pointer can't be looked at once realloc freed it, so untrack it first
+        Allocation old;
+        bool oldingame;
+        bool wastracked = heapstats_untrack(ptr, &old, &oldingame);
+        newptr = realloc(ptr, size);
+        if (newptr != NULL || size == 0)
+            heapstats_track(newptr, size, file, line);
+        else if (wastracked)
+            heapstats_insert(old, oldingame); // Failed, so the old block is still alive
+    #else
+        newptr = realloc(ptr, size);
+    #endif
+    return newptr;
+}
+
+void heapstats_free(void* ptr)
+{
+    #if HEAP_TRACKING
+        heapstats_untrack(ptr, NULL, NULL);
+    #endif
+    free(ptr);
+}
@@ -0,0 +1,37 @@
+#ifndef GAMEJAM2024_HEAPSTATS_H
+#define GAMEJAM2024_HEAPSTATS_H
+
+#include <libdragon.h>
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /***************************************************************
+                      Internal Heap Stats Functions
+                  Do not use anything below this line
+    ***************************************************************/
+
+    extern void heapstats_begin(const char* name);
+    extern void heapstats_sample();
+    extern void heapstats_end();
+
+    extern void* heapstats_malloc(size_t size, const char* file, int line);
+    extern void* heapstats_calloc(size_t count, size_t size, const char* file, int line);
+    extern void* heapstats_realloc(void* ptr, size_t size, const char* file, int line);
+    extern void  heapstats_free(void* ptr);
+
+    // Tag every allocation made by the levels with the place it was made from
+    #if HEAP_TRACKING && !defined(HEAPSTATS_NO_REDIRECT)
+        #define malloc(size)         heapstats_malloc(size, __FILE__, __LINE__)
+        #define calloc(count, size)  heapstats_calloc(count, size, __FILE__, __LINE__)
+        #define realloc(ptr, size)   heapstats_realloc(ptr, size, __FILE__, __LINE__)
+        #define free(ptr)            heapstats_free(ptr)
+    #endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -8,6 +8,7 @@ and provides a basic game loop.
 #include <libdragon.h>
 #include <time.h>
 #include <unistd.h>
+#include <string.h>
 #include "core.h"
 #include "logo.h"
 #include "menu.h"
@@ -52,10 +53,20 @@ int main()
 
     // Initialize the random number generator, then call rand() every
     // frame so to get random behavior also in emulators.
+    // Replays need the exact same sequence of random numbers, so they skip the latter
     uint32_t seed;
     getentropy(&seed, sizeof(seed));
+    #if REPLAY_MODE != REPLAY_OFF
+        if (!strncmp(REPLAY_FILE, "sd:/", 4))
+            debug_init_sdfs("sd:/", -1);
+        if (REPLAY_MODE == REPLAY_RECORD)
+            replay_start_recording(REPLAY_FILE, seed);
+        else
+            replay_start_playback(REPLAY_FILE, &seed);
+    #endif
     srand(seed);
-    register_VI_handler((void(*)(void))rand);
+    if (replay_get_mode() == REPLAY_OFF)
+        register_VI_handler((void(*)(void))rand);
 
     // Show logos
     if (sys_reset_type() == RESET_COLD) {
@@ -84,6 +95,7 @@ int main()
             // In order to prevent problems if the game slows down significantly, we will clamp the maximum timestep the simulation can take
             if (frametime > 0.25f)
                 frametime = 0.25f;
+            frametime = replay_frametime(frametime);
             
             // Perform the update in discrete steps (ticks)
             accumulator += frametime;
@@ -94,15 +106,17 @@ int main()
             }
 
             // Read controler data
-            joypad_poll();
+            replay_poll();
             mixer_try_play();
             
             // Perform the unfixed loop
             core_set_subtick(((double)accumulator)/((double)dt));
             core_level_doloop(frametime);
+            core_level_endframe();
         }
         
         // End the current level
         core_level_docleanup();
+        replay_save();
     }
 }
\ No newline at end of file
@@ -232,10 +232,6 @@ void menu_init()
     wav64_open(&sfx_back, "rom:/core/menu_back.wav64");
     wav64_open(&sfx_drumroll, "rom:/core/DrumRoll.wav64");
     wav64_open(&sfx_crash, "rom:/core/Crash.wav64");
-    xm64player_open(&global_music, "rom:/core/Menus.xm64");
-    xm64player_seek(&global_music, 62, 0, 0);
-    xm64player_set_vol(&global_music, 0.0f);
-    xm64player_play(&global_music, 0);
 
     savestate_getblacklist(blacklist);
     for (int i = 0; i < global_minigame_count; i++)
@@ -257,6 +253,12 @@ void menu_init()
     {
         if ((core_get_nextround() != NR_ROBIN && (is_first_time || core_get_nextround() == NR_RANDOMGAME)) || core_get_curchooser() >= core_get_playercount())
         {
+            ai_target = rand() % minigamecount;
+
+            // The game is already decided, so open it now while the menu is loading anyway, instead of between the menu and the game.
+            // This blocks, so it has to happen before any audio starts, as nothing polls the mixer until the first frame
+            minigame_openearly(global_minigame_list[sorted_indices[ai_target]].internalname);
+
             if (core_get_nextround() != NR_ROBIN && (is_first_time || core_get_nextround() == NR_RANDOMGAME))
             {
                 roulette = 2.0f;
@@ -265,10 +267,14 @@ void menu_init()
             }
             else
                 ai_nexttime = 1.0f;
-            ai_target = rand() % minigamecount;
         }
     }
 
+    xm64player_open(&global_music, "rom:/core/Menus.xm64");
+    xm64player_seek(&global_music, 62, 0, 0);
+    xm64player_set_vol(&global_music, 0.0f);
+    xm64player_play(&global_music, 0);
+
     // Set the initial menu screen
     set_menu_screen(SCREEN_MINIGAME);
 }
@@ -612,6 +618,8 @@ void menu_loop(float deltatime)
 
 void menu_cleanup()
 {
+    // Backing out or picking a different game leaves an unused early open behind
+    minigame_openearly_cancel();
     free(sorted_indices);
     rspq_wait();
     
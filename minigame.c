@@ -10,6 +10,16 @@ The file contains the minigame manager
 #include "minigame.h"
 
 
+/*********************************
+           Definitions
+*********************************/
+
+// Must match tools/mkmanifest
+#define MANIFEST_VERSION     1
+#define MANIFEST_FIELDS      5
+#define MANIFEST_HEADERSIZE  16
+
+
 /*********************************
              Globals
 *********************************/
@@ -23,68 +33,130 @@ size_t    global_minigame_count;
 // Helper consts
 static const char*  global_minigamepath = "rom:/minigames/";
 static const size_t global_minigamepath_len = 15;
+static const char*  global_minigamemanifest = "rom:/minigames.manifest";
+
+// Minigame opened ahead of minigame_loadnext
+static Minigame* global_minigame_early = NULL;
+static void*     global_minigame_early_handle = NULL;
+
+
+/*==============================
+    manifest_read_u32
+    Reads a big endian integer from the manifest
+    @param  The manifest data to read from
+    @return The integer
+==============================*/
+
+static uint32_t manifest_read_u32(const uint8_t* data)
+{
+    return (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+}
 
 
 /*==============================
     minigame_loadall
-    Loads all the minigames from the filesystem
+    Loads all the minigames from the manifest that was generated
+    at build time, so that no DSO needs to be opened until a
+    minigame is actually played
 ==============================*/
 
 void minigame_loadall()
 {
-    size_t gamecount = 0;
-    dir_t minigamesdir;
-
-    // First, go through the minigames path and count the number of minigames
-    dir_findfirst(global_minigamepath, &minigamesdir);
-    do
+    int size;
+    uint32_t strtabsize;
+    const uint8_t* records;
+    char* strtab;
+
+    // The manifest stays in memory for good, since the definitions point into its string table
+    uint8_t* manifest = asset_load(global_minigamemanifest, &size);
+    assertf(size >= MANIFEST_HEADERSIZE && !memcmp(manifest, "MGMF", 4), "Invalid minigame manifest %s", global_minigamemanifest);
+    assertf(manifest_read_u32(manifest + 4) == MANIFEST_VERSION, "Minigame manifest version mismatch");
+    global_minigame_count = manifest_read_u32(manifest + 8);
+    strtabsize = manifest_read_u32(manifest + 12);
+    records = manifest + MANIFEST_HEADERSIZE;
+    strtab = (char*)records + global_minigame_count*MANIFEST_FIELDS*4;
+    assertf((uint8_t*)strtab + strtabsize == manifest + size, "Minigame manifest is corrupt");
+
+    // Register all the known minigames
+    global_minigame_list = (Minigame*)calloc(global_minigame_count, sizeof(Minigame));
+    for (size_t i=0; i<global_minigame_count; i++)
     {
-        if (!strstr(minigamesdir.d_name, ".sym"))
-            gamecount++;
+        Minigame* newdef = &global_minigame_list[i];
+        const uint8_t* record = records + i*MANIFEST_FIELDS*4;
+        newdef->internalname             = strtab + manifest_read_u32(record + 0);
+        newdef->definition.gamename      = strtab + manifest_read_u32(record + 4);
+        newdef->definition.developername = strtab + manifest_read_u32(record + 8);
+        newdef->definition.description   = strtab + manifest_read_u32(record + 12);
+        newdef->definition.instructions  = strtab + manifest_read_u32(record + 16);
     }
-    while (dir_findnext(global_minigamepath, &minigamesdir) == 0);
-    global_minigame_count = gamecount;
+}
 
-    // Allocate the list of minigames
-    global_minigame_list = (Minigame*)malloc(sizeof(Minigame) * gamecount);
 
-    // Look through the minigames path and register all the known minigames
-    gamecount = 0;
-    dir_findfirst(global_minigamepath, &minigamesdir);
-    do
-    {
-        void* handle;
-        MinigameDef* loadeddef;
-        Minigame* newdef = &global_minigame_list[gamecount];
-        char* filename = minigamesdir.d_name;
-
-        // Ignore the symbol file
-        if (strstr(filename, ".sym"))
-            continue;
-
-        // Get the filepath and open the dso
-        char fullpath[global_minigamepath_len + strlen(filename) + 1];
-        sprintf(fullpath, "%s%s", global_minigamepath, filename);
-        handle = dlopen(fullpath, RTLD_LOCAL);
-
-        // Get the symbols of the minigame definition. 
-        // Since these symbols will only be temporarily stored in memory, we must make a deep copy
-        loadeddef = dlsym(handle, "minigame_def");
-        assertf(loadeddef, "Unable to find symbol minigame_def in %s\n", filename);
-        newdef->definition.gamename      = strdup(loadeddef->gamename);
-        newdef->definition.developername = strdup(loadeddef->developername);
-        newdef->definition.description   = strdup(loadeddef->description);
-        newdef->definition.instructions  = strdup(loadeddef->instructions);
-
-        // Set the internal name as the filename without the extension
-        strrchr(filename, '.')[0] = '\0';
-        newdef->internalname = strdup(filename);
-
-        // Cleanup
-        dlclose(handle);
-        gamecount++;
-    }
-    while (dir_findnext("rom:/minigames/", &minigamesdir) == 0);
+/*==============================
+    minigame_find
+    Finds a minigame by its internal name
+    @param  The internal filename of the minigame
+    @return The minigame
+==============================*/
+
+static Minigame* minigame_find(char* name)
+{
+    for (size_t i=0; i<global_minigame_count; i++)
+        if (!strcmp(global_minigame_list[i].internalname, name))
+            return &global_minigame_list[i];
+    assertf(0, "Unable to find minigame with internal name '%s'", name);
+    return NULL;
+}
+
+
+/*==============================
+    minigame_open
+    Opens a minigame's DSO
+    @param  The minigame to open
+    @return The DSO handle
+==============================*/
+
+static void* minigame_open(Minigame* game)
+{
+    char fullpath[global_minigamepath_len + strlen(game->internalname) + 4 + 1];
+    sprintf(fullpath, "%s%s.dso", global_minigamepath, game->internalname);
+    return dlopen(fullpath, RTLD_LOCAL);
+}
+
+
+/*==============================
+    minigame_openearly_cancel
+    Closes the minigame opened by minigame_openearly, if it
+    wasn't entered with minigame_loadnext
+==============================*/
+
+void minigame_openearly_cancel()
+{
+    if (global_minigame_early_handle != NULL)
+        dlclose(global_minigame_early_handle);
+    global_minigame_early_handle = NULL;
+    global_minigame_early = NULL;
+}
+
+
+/*==============================
+    minigame_openearly
+    Opens a minigame's DSO right away, so that entering it
+    later with minigame_loadnext doesn't have to. This is not
+    asynchronous: it blocks until the DSO is read and relocated,
+    so only call it where the game is already loading, and
+    before starting any audio.
+    @param  The internal filename of the minigame to open
+==============================*/
+
+void minigame_openearly(char* name)
+{
+    Minigame* game = minigame_find(name);
+    if (global_minigame_early == game)
+        return;
+    minigame_openearly_cancel();
+    global_minigame_early = game;
+    global_minigame_early_handle = minigame_open(game);
 }
 
 
@@ -99,23 +171,19 @@ void minigame_loadnext(char* name)
     //debugf("Loading minigame: %s\n", name);
 
     // Find the minigame with that name
-    global_minigame_current = NULL;
-    for (size_t i=0; i<global_minigame_count; i++)
-    {
-        if (!strcmp(global_minigame_list[i].internalname, name))
-        {
-            //debugf("Success!\n");
-            global_minigame_current = &global_minigame_list[i];
-            break;
-        }
-    }
-    assertf(global_minigame_current != NULL, "Unable to find minigame with internal name '%s'", name);
+    global_minigame_current = minigame_find(name);
 
-    // Load the dso and assign the internal functions
-    char fullpath[global_minigamepath_len + strlen(name) + 4 + 1];
-    sprintf(fullpath, "%s%s.dso", global_minigamepath, name);
-    global_minigame_current->handle = dlopen(fullpath, RTLD_LOCAL);
+    // Load the dso, unless it was already opened early
+    if (global_minigame_early != global_minigame_current)
+        minigame_openearly_cancel();
+    if (global_minigame_early_handle != NULL)
+        global_minigame_current->handle = global_minigame_early_handle;
+    else
+        global_minigame_current->handle = minigame_open(global_minigame_current);
+    global_minigame_early_handle = NULL;
+    global_minigame_early = NULL;
 
+    // Assign the internal functions
     global_minigame_current->funcPointer_init      = dlsym(global_minigame_current->handle, "minigame_init");
     global_minigame_current->funcPointer_loop      = dlsym(global_minigame_current->handle, "minigame_loop");
     global_minigame_current->funcPointer_fixedloop = dlsym(global_minigame_current->handle, "minigame_fixedloop");
@@ -51,6 +51,8 @@ extern "C" {
 
     void      minigame_loadall();
     void      minigame_loadnext(char* name);
+    void      minigame_openearly(char* name);
+    void      minigame_openearly_cancel();
     void      minigame_cleanup();
     Minigame* minigame_get_game();
     int       minigame_get_index();
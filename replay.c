@@ -0,0 +1,485 @@
+/***************************************************************
+                            replay.c
+
+The file contains the input recorder, which captures the joypad
+state of all four ports every frame (along with the frame's
+delta time and the random seed) so that a session can be played
+back identically later.
+
+Every joypad read made by the levels goes through this file (see
+the redirects in replay.h). When recording or playing back, the
+levels only ever see the frame's snapshot, so extra polls made
+by a minigame don't change what it reads.
+
+Replays are stored in the native byte order and are only meant
+to be played back on the platform that recorded them:
+  char     magic[4]     "NBRP"
+  uint32_t version
+  uint32_t seed
+  uint32_t framecount
+  Then, for each frame:
+  uint8_t  changedports  Bitmask of the ports whose inputs changed
+  uint8_t  connected     Bitmask of the connected ports
+  uint16_t frametime     In units of REPLAY_TIMEUNIT seconds
+  joypad_inputs_t        For every port in changedports
+***************************************************************/
+
+#define REPLAY_NO_REDIRECT
+#include <libdragon.h>
+#include "core.h"
+
+
+/*********************************
+           Definitions
+*********************************/
+
+#define REPLAY_VERSION     1
+#define REPLAY_HEADERSIZE  16
+
+// Frame times are stored in 4 microsecond units, which covers the 0.25 second clamp done in main.c
+#define REPLAY_TIMEUNIT    0.000004f
+
+// How far an axis needs to be pushed to count as a digital direction
+#define REPLAY_AXIS_DEADZONE  32
+
+// While recording, frames are buffered and written to disk once this many bytes have been collected
+#define REPLAY_CHUNKSIZE      4096
+#define REPLAY_FRAMEMAXSIZE   (4 + JOYPAD_PORT_COUNT*sizeof(joypad_inputs_t))
+
+
+/*********************************
+             Globals
+*********************************/
+
+static ReplayMode  global_replay_mode = REPLAY_OFF;
+static const char* global_replay_path;
+
+// Replay stream. When recording, only holds what wasn't written to global_replay_file yet
+static uint8_t* global_replay_data = NULL;
+static size_t   global_replay_size;
+static size_t   global_replay_cursor;
+static FILE*    global_replay_file = NULL;
+static uint32_t global_replay_framecount;
+static uint32_t global_replay_seed;
+
+// Joypad snapshot of the current and previous frames
+static joypad_inputs_t global_replay_cur[JOYPAD_PORT_COUNT];
+static joypad_inputs_t global_replay_prev[JOYPAD_PORT_COUNT];
+static uint8_t         global_replay_connected;
+
+
+/*==============================
+    replay_write
+    Appends data to the replay stream being recorded
+    @param  The data to append
+    @param  The size of the data
+==============================*/
+
+static void replay_write(const void* data, size_t size)
+{
+    assertf(global_replay_size + size <= REPLAY_CHUNKSIZE + REPLAY_FRAMEMAXSIZE, "Replay buffer overflow");
+    memcpy(global_replay_data + global_replay_size, data, size);
+    global_replay_size += size;
+}
+
+
+/*==============================
+    replay_flush
+    Writes the buffered part of the recording to disk
+==============================*/
+
+static void replay_flush()
+{
+    if (global_replay_file == NULL || global_replay_size == 0)
+        return;
+    fwrite(global_replay_data, 1, global_replay_size, global_replay_file);
+    global_replay_size = 0;
+}
+
+
+/*==============================
+    replay_read
+    Reads data from the replay stream being played back
+    @param  Where to copy the data to
+    @param  The size of the data
+    @return Whether there was enough data left
+==============================*/
+
+static bool replay_read(void* data, size_t size)
+{
+    if (global_replay_cursor + size > global_replay_size)
+        return false;
+    memcpy(data, global_replay_data + global_replay_cursor, size);
+    global_replay_cursor += size;
+    return true;
+}
+
+
+/*==============================
+    replay_start_recording
+    Starts recording inputs. The recording is written to disk
+    in chunks while recording, and completed every time
+    replay_save is called
+    @param  The file to save the recording to
+    @param  The seed that was given to srand
+==============================*/
+
+void replay_start_recording(const char* path, uint32_t seed)
+{
+    if (global_replay_file != NULL)
+        fclose(global_replay_file);
+    global_replay_file = fopen(path, "wb");
+    if (global_replay_file == NULL)
+    {
+        debugf("Unable to write replay %s\n", path);
+        global_replay_mode = REPLAY_OFF;
+        return;
+    }
+
+    global_replay_mode = REPLAY_RECORD;
+    global_replay_path = path;
+    global_replay_seed = seed;
+    global_replay_framecount = 0;
+    global_replay_size = 0;
+    free(global_replay_data);
+    global_replay_data = malloc(REPLAY_CHUNKSIZE + REPLAY_FRAMEMAXSIZE);
+    replay_write("NBRP", 4);
+    replay_write(&(uint32_t){REPLAY_VERSION}, 4);
+    replay_write(&seed, 4);
+    replay_write(&global_replay_framecount, 4);
+    memset(global_replay_cur, 0, sizeof(global_replay_cur));
+    memset(global_replay_prev, 0, sizeof(global_replay_prev));
+}
+
+
+/*==============================
+    replay_start_playback
+    Starts playing back a recording
+    @param  The file to play back
+    @param  Where to store the seed that should be given to srand
+    @return Whether the file could be loaded
+==============================*/
+
+bool replay_start_playback(const char* path, uint32_t* seed)
+{
+    FILE* f = fopen(path, "rb");
+    uint32_t version;
+    if (f == NULL)
+    {
+        debugf("Unable to open replay %s\n", path);
+        return false;
+    }
+
+    // Read the whole stream
+    fseek(f, 0, SEEK_END);
+    global_replay_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    free(global_replay_data);
+    global_replay_data = malloc(global_replay_size);
+    global_replay_size = fread(global_replay_data, 1, global_replay_size, f);
+    fclose(f);
+
+    // Validate it
+    global_replay_cursor = 4;
+    if (global_replay_size < REPLAY_HEADERSIZE || memcmp(global_replay_data, "NBRP", 4) != 0)
+    {
+        debugf("%s is not a replay\n", path);
+        return false;
+    }
+    replay_read(&version, 4);
+    replay_read(&global_replay_seed, 4);
+    replay_read(&global_replay_framecount, 4);
+    if (version != REPLAY_VERSION)
+    {
+        debugf("Replay %s has version %ld, expected %d\n", path, (long)version, REPLAY_VERSION);
+        return false;
+    }
+
+    // Success
+    global_replay_mode = REPLAY_PLAY;
+    global_replay_path = path;
+    memset(global_replay_cur, 0, sizeof(global_replay_cur));
+    memset(global_replay_prev, 0, sizeof(global_replay_prev));
+    *seed = global_replay_seed;
+    return true;
+}
+
+
+/*==============================
+    replay_save
+    Writes the rest of the recording made so far to disk, and
+    updates the frame count in its header
+==============================*/
+
+void replay_save()
+{
+    if (global_replay_mode != REPLAY_RECORD)
+        return;
+    replay_flush();
+    fseek(global_replay_file, 12, SEEK_SET);
+    fwrite(&global_replay_framecount, 4, 1, global_replay_file);
+    fseek(global_replay_file, 0, SEEK_END);
+    fflush(global_replay_file);
+}
+
+
+/*==============================
+    replay_get_mode
+    Gets whether inputs are being recorded or played back
+    @return The replay mode
+==============================*/
+
+ReplayMode replay_get_mode()
+{
+    return global_replay_mode;
+}
+
+
+/*==============================
+    replay_frametime
+    Passes a frame's delta time through the replay system. When
+    recording, it's rounded to what the stream can store so that
+    playback sees the exact same value. When playing back, the
+    recorded value is returned instead.
+    @param  The real frame delta time
+    @return The frame delta time to simulate
+==============================*/
+
+float replay_frametime(float frametime)
+{
+    uint16_t units;
+    switch (global_replay_mode)
+    {
+        case REPLAY_RECORD:
+            units = (uint16_t)(frametime/REPLAY_TIMEUNIT + 0.5f);
+            replay_write(&(uint8_t){0}, 1);
+            replay_write(&(uint8_t){0}, 1);
+            replay_write(&units, 2);
+            return units*REPLAY_TIMEUNIT;
+        case REPLAY_PLAY:
+            if (global_replay_cursor + 4 > global_replay_size)
+                return frametime;
+            memcpy(&units, global_replay_data + global_replay_cursor + 2, 2);
+            return units*REPLAY_TIMEUNIT;
+        default:
+            return frametime;
+    }
+}
+
+
+/*==============================
+    replay_poll
+    Reads this frame's joypad inputs, either from the
+    controllers or from the replay. Call once per frame, after
+    replay_frametime.
+==============================*/
+
+void replay_poll()
+{
+    uint8_t changed = 0;
+    uint16_t units;
+
+    if (global_replay_mode == REPLAY_OFF)
+    {
+        joypad_poll();
+        return;
+    }
+    memcpy(global_replay_prev, global_replay_cur, sizeof(global_replay_cur));
+
+    // When recording, fill in the frame header that replay_frametime started
+    if (global_replay_mode == REPLAY_RECORD)
+    {
+        uint8_t* frame = global_replay_data + global_replay_size - 4;
+        joypad_poll();
+        global_replay_connected = 0;
+        JOYPAD_PORT_FOREACH(port)
+        {
+            joypad_inputs_t inputs = joypad_get_inputs(port);
+            if (joypad_is_connected(port))
+                global_replay_connected |= 1 << port;
+            if (memcmp(&inputs, &global_replay_cur[port], sizeof(joypad_inputs_t)) != 0)
+            {
+                changed |= 1 << port;
+                global_replay_cur[port] = inputs;
+            }
+        }
+        frame[0] = changed;
+        frame[1] = global_replay_connected;
+        JOYPAD_PORT_FOREACH(port)
+            if (changed & (1 << port))
+                replay_write(&global_replay_cur[port], sizeof(joypad_inputs_t));
+        global_replay_framecount++;
+
+        // Only whole frames are written, since the frame header above is filled in after replay_frametime
+        if (global_replay_size >= REPLAY_CHUNKSIZE)
+            replay_flush();
+        return;
+    }
+
+    // Otherwise, read the next frame from the stream. Once it runs out, give control back to the controllers
+    if (!replay_read(&changed, 1) || !replay_read(&global_replay_connected, 1) || !replay_read(&units, 2))
+    {
+        debugf("Replay %s finished\n", global_replay_path);
+        global_replay_mode = REPLAY_OFF;
+        joypad_poll();
+        return;
+    }
+    JOYPAD_PORT_FOREACH(port)
+        if (changed & (1 << port))
+            replay_read(&global_replay_cur[port], sizeof(joypad_inputs_t));
+}
+
+
+/*==============================
+    replay_axis_value
+    Gets the value of an axis from a joypad snapshot
+    @param  The joypad snapshot
+    @param  The axis to read
+    @return The axis value
+==============================*/
+
+static int replay_axis_value(const joypad_inputs_t* inputs, joypad_axis_t axis)
+{
+    switch (axis)
+    {
+        case JOYPAD_AXIS_STICK_X:  return inputs->stick_x;
+        case JOYPAD_AXIS_STICK_Y:  return inputs->stick_y;
+        case JOYPAD_AXIS_CSTICK_X: return inputs->cstick_x;
+        case JOYPAD_AXIS_CSTICK_Y: return inputs->cstick_y;
+        case JOYPAD_AXIS_ANALOG_L: return inputs->analog_l;
+        case JOYPAD_AXIS_ANALOG_R: return inputs->analog_r;
+    }
+    return 0;
+}
+
+
+/*==============================
+    replay_axis_direction
+    Turns an axis value into a digital direction
+    @param  The axis value
+    @return -1, 0 or 1
+==============================*/
+
+static int replay_axis_direction(int value)
+{
+    if (value > REPLAY_AXIS_DEADZONE)
+        return 1;
+    if (value < -REPLAY_AXIS_DEADZONE)
+        return -1;
+    return 0;
+}
+
+
+/*********************************
+        Joypad Redirects
+*********************************/
+
+void replay_joypad_poll()
+{
+    // Levels only see the snapshot taken by replay_poll while recording or playing back
+    if (global_replay_mode == REPLAY_OFF)
+        joypad_poll();
+}
+
+bool replay_joypad_is_connected(joypad_port_t port)
+{
+    if (global_replay_mode == REPLAY_OFF)
+        return joypad_is_connected(port);
+    return (global_replay_connected >> port) & 0x01;
+}
+
+joypad_inputs_t replay_joypad_get_inputs(joypad_port_t port)
+{
+    if (global_replay_mode == REPLAY_OFF)
+        return joypad_get_inputs(port);
+    return global_replay_cur[port];
+}
+
+joypad_buttons_t replay_joypad_get_buttons(joypad_port_t port)
+{
+    if (global_replay_mode == REPLAY_OFF)
+        return joypad_get_buttons(port);
+    return global_replay_cur[port].btn;
+}
+
+joypad_buttons_t replay_joypad_get_buttons_pressed(joypad_port_t port)
+{
+    if (global_replay_mode == REPLAY_OFF)
+        return joypad_get_buttons_pressed(port);
+    return (joypad_buttons_t){.raw = global_replay_cur[port].btn.raw & ~global_replay_prev[port].btn.raw};
+}
+
+joypad_buttons_t replay_joypad_get_buttons_released(joypad_port_t port)
+{
+    if (global_replay_mode == REPLAY_OFF)
+        return joypad_get_buttons_released(port);
+    return (joypad_buttons_t){.raw = ~global_replay_cur[port].btn.raw & global_replay_prev[port].btn.raw};
+}
+
+joypad_buttons_t replay_joypad_get_buttons_held(joypad_port_t port)
+{
+    if (global_replay_mode == REPLAY_OFF)
+        return joypad_get_buttons_held(port);
+    return (joypad_buttons_t){.raw = global_replay_cur[port].btn.raw & global_replay_prev[port].btn.raw};
+}
+
+joypad_8way_t replay_joypad_get_direction(joypad_port_t port, joypad_2d_t axes)
+{
+    static const joypad_8way_t table[3][3] = {
+        {JOYPAD_8WAY_DOWN_LEFT,  JOYPAD_8WAY_LEFT,  JOYPAD_8WAY_UP_LEFT},
+        {JOYPAD_8WAY_DOWN,       JOYPAD_8WAY_NONE,  JOYPAD_8WAY_UP},
+        {JOYPAD_8WAY_DOWN_RIGHT, JOYPAD_8WAY_RIGHT, JOYPAD_8WAY_UP_RIGHT},
+    };
+    const joypad_inputs_t* in = &global_replay_cur[port];
+    int x = 0, y = 0;
+    if (global_replay_mode == REPLAY_OFF)
+        return joypad_get_direction(port, axes);
+    if (axes == JOYPAD_2D_DPAD || axes == JOYPAD_2D_LH || axes == JOYPAD_2D_ANY)
+    {
+        x += in->btn.d_right - in->btn.d_left;
+        y += in->btn.d_up - in->btn.d_down;
+    }
+    if (axes == JOYPAD_2D_STICK || axes == JOYPAD_2D_LH || axes == JOYPAD_2D_LR || axes == JOYPAD_2D_ANY)
+    {
+        x += replay_axis_direction(in->stick_x);
+        y += replay_axis_direction(in->stick_y);
+    }
+    if (axes == JOYPAD_2D_CSTICK || axes == JOYPAD_2D_RH || axes == JOYPAD_2D_LR || axes == JOYPAD_2D_ANY)
+    {
+        x += in->btn.c_right - in->btn.c_left;
+        y += in->btn.c_up - in->btn.c_down;
+    }
+    x = (x > 0) - (x < 0);
+    y = (y > 0) - (y < 0);
+    return table[x+1][y+1];
+}
+
+int replay_joypad_get_axis_pressed(joypad_port_t port, joypad_axis_t axis)
+{
+    int cur, prev;
+    if (global_replay_mode == REPLAY_OFF)
+        return joypad_get_axis_pressed(port, axis);
+    cur = replay_axis_direction(replay_axis_value(&global_replay_cur[port], axis));
+    prev = replay_axis_direction(replay_axis_value(&global_replay_prev[port], axis));
+    return (cur != prev) ? cur : 0;
+}
+
+int replay_joypad_get_axis_released(joypad_port_t port, joypad_axis_t axis)
+{
+    int cur, prev;
+    if (global_replay_mode == REPLAY_OFF)
+        return joypad_get_axis_released(port, axis);
+    cur = replay_axis_direction(replay_axis_value(&global_replay_cur[port], axis));
+    prev = replay_axis_direction(replay_axis_value(&global_replay_prev[port], axis));
+    return (cur != prev) ? prev : 0;
+}
+
+int replay_joypad_get_axis_held(joypad_port_t port, joypad_axis_t axis)
+{
+    int cur, prev;
+    if (global_replay_mode == REPLAY_OFF)
+        return joypad_get_axis_held(port, axis);
+    cur = replay_axis_direction(replay_axis_value(&global_replay_cur[port], axis));
+    prev = replay_axis_direction(replay_axis_value(&global_replay_prev[port], axis));
+    return (cur == prev) ? cur : 0;
+}
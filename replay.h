@@ -0,0 +1,61 @@
+#ifndef GAMEJAM2024_REPLAY_H
+#define GAMEJAM2024_REPLAY_H
+
+#include <libdragon.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // Replay modes. These are macros rather than an enum so that config.h's REPLAY_MODE can be checked with #if
+    #define REPLAY_OFF     0
+    #define REPLAY_RECORD  1
+    #define REPLAY_PLAY    2
+
+    typedef int ReplayMode;
+
+
+    /***************************************************************
+                        Internal Replay Functions
+                  Do not use anything below this line
+    ***************************************************************/
+
+    extern void       replay_start_recording(const char* path, uint32_t seed);
+    extern bool       replay_start_playback(const char* path, uint32_t* seed);
+    extern void       replay_save();
+    extern ReplayMode replay_get_mode();
+    extern float      replay_frametime(float frametime);
+    extern void       replay_poll();
+
+    extern void             replay_joypad_poll();
+    extern bool             replay_joypad_is_connected(joypad_port_t port);
+    extern joypad_inputs_t  replay_joypad_get_inputs(joypad_port_t port);
+    extern joypad_buttons_t replay_joypad_get_buttons(joypad_port_t port);
+    extern joypad_buttons_t replay_joypad_get_buttons_pressed(joypad_port_t port);
+    extern joypad_buttons_t replay_joypad_get_buttons_released(joypad_port_t port);
+    extern joypad_buttons_t replay_joypad_get_buttons_held(joypad_port_t port);
+    extern joypad_8way_t    replay_joypad_get_direction(joypad_port_t port, joypad_2d_t axes);
+    extern int              replay_joypad_get_axis_pressed(joypad_port_t port, joypad_axis_t axis);
+    extern int              replay_joypad_get_axis_released(joypad_port_t port, joypad_axis_t axis);
+    extern int              replay_joypad_get_axis_held(joypad_port_t port, joypad_axis_t axis);
+
+    // Route every joypad read through the replay system, so recorded inputs can be fed back to the levels
+    #ifndef REPLAY_NO_REDIRECT
+        #define joypad_poll()                              replay_joypad_poll()
+        #define joypad_is_connected(port)                  replay_joypad_is_connected(port)
+        #define joypad_get_inputs(port)                    replay_joypad_get_inputs(port)
+        #define joypad_get_buttons(port)                   replay_joypad_get_buttons(port)
+        #define joypad_get_buttons_pressed(port)           replay_joypad_get_buttons_pressed(port)
+        #define joypad_get_buttons_released(port)          replay_joypad_get_buttons_released(port)
+        #define joypad_get_buttons_held(port)              replay_joypad_get_buttons_held(port)
+        #define joypad_get_direction(port, axes)           replay_joypad_get_direction(port, axes)
+        #define joypad_get_axis_pressed(port, axis)        replay_joypad_get_axis_pressed(port, axis)
+        #define joypad_get_axis_released(port, axis)       replay_joypad_get_axis_released(port, axis)
+        #define joypad_get_axis_held(port, axis)           replay_joypad_get_axis_held(port, axis)
+    #endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -6,30 +6,57 @@ loaded if it crashes
 ***************************************************************/
 
 #include <libdragon.h>
+#include <stddef.h>
 #include "core.h"
 #include "minigame.h"
 #include "results.h"
 #include "savestate.h"
 
 
+/*********************************
+           Definitions
+*********************************/
+
+// The save is kept twice in EEPROM, each write goes to the slot with the older copy
+#define SAVESLOT_COUNT  2
+#define SAVESLOT_SIZE   32
+#define SAVESLOT_BLOCKS (SAVESLOT_SIZE/SAVE_BLOCK_SIZE)
+
+// EEPROM is written in blocks of this many bytes
+#define SAVE_BLOCK_SIZE  8
+
+// Changing the layout of GameSave requires changing this, so old saves are ignored
+#define SAVE_HEADER  "NBG2"
+
+
 /*********************************
             Structures
 *********************************/
 
+// Fields are grouped by how often they change, so that saves only touch a few EEPROM blocks
 typedef struct {
+    // Block 0
     char header[4];
+    uint32_t sequence;
+    // Block 1
     uint32_t blacklist;
-    uint8_t crashedflag;
     uint8_t aidiff;
     uint8_t pointstowin;
     uint8_t nextplaystyle;
+    uint8_t padding1;
+    // Block 2
     uint8_t playerconts[MAXPLAYERS];
     uint8_t points[MAXPLAYERS];
+    // Block 3
+    uint8_t crashedflag;
     uint8_t chooser;
     uint8_t curgame;
-    uint8_t checksum;
+    uint8_t padding2;
+    uint32_t crc;
 } GameSave;
 
+_Static_assert(sizeof(GameSave) == SAVESLOT_SIZE, "GameSave must fill a save slot exactly");
+
 
 /*********************************
        Function Prototypes
@@ -49,21 +76,70 @@ static uint8_t global_cansave;
 static GameSave global_gamesave;
 static rdpq_font_t* global_font;
 
+// What each save slot in EEPROM currently holds, and which slot has the latest save
+static uint8_t global_saveslots[SAVESLOT_COUNT][SAVESLOT_SIZE];
+static int global_curslot;
+
+
+/*==============================
+    calc_crc
+    Calculate the CRC-32 of a save slot, excluding the CRC
+    itself
+    @param  The save to calculate the CRC of
+    @return The CRC
+==============================*/
+
+static uint32_t calc_crc(const GameSave* save)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    const uint8_t* asarray = (const uint8_t*)save;
+    for (int i=0; i<offsetof(GameSave, crc); i++)
+    {
+        crc ^= asarray[i];
+        for (int j=0; j<8; j++)
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+    return ~crc;
+}
+
 
 /*==============================
-    calc_checksum
-    Calculate a basic checksum for the save state
-    This is done by just adding all the bytes together
-    @return The checksum
+    slot_isvalid
+    Check whether a save slot holds an intact save
+    @param  The save slot to check
+    @return Whether the slot is valid
 ==============================*/
 
-static uint8_t calc_checksum()
+static bool slot_isvalid(const GameSave* save)
 {
-    uint8_t checksum = 0;
+    return strncmp(save->header, SAVE_HEADER, 4) == 0 && save->crc == calc_crc(save);
+}
+
+
+/*==============================
+    savestate_write
+    Write the save to the slot holding the older copy, only
+    touching the EEPROM blocks that differ from what it holds.
+    If a write is interrupted, the other slot remains intact.
+==============================*/
+
+static void savestate_write()
+{
+    int slot = (global_curslot + 1) % SAVESLOT_COUNT;
     uint8_t* asarray = (uint8_t*)&global_gamesave;
-    for (int i=0; i<sizeof(GameSave); i++)
-        checksum += asarray[i];
-    return checksum;
+
+    global_gamesave.sequence++;
+    global_gamesave.crc = calc_crc(&global_gamesave);
+    for (int i=0; i<SAVESLOT_BLOCKS; i++)
+    {
+        uint8_t* block = asarray + i*SAVE_BLOCK_SIZE;
+        uint8_t* saved = global_saveslots[slot] + i*SAVE_BLOCK_SIZE;
+        if (memcmp(block, saved, SAVE_BLOCK_SIZE) == 0)
+            continue;
+        eeprom_write(slot*SAVESLOT_BLOCKS + i, block);
+        memcpy(saved, block, SAVE_BLOCK_SIZE);
+    }
+    global_curslot = slot;
 }
 
 
@@ -82,19 +158,29 @@ bool savestate_initialize()
         return false;
     global_cansave = 1;
         
-    // Read the savestate from EEPROM
-    eeprom_read_bytes((uint8_t*)(&global_gamesave), 0, sizeof(GameSave));
+    // Read both save slots from EEPROM
+    eeprom_read_bytes((uint8_t*)global_saveslots, 0, sizeof(global_saveslots));
+
+    // Use the newest intact slot. The sequence comparison is done so that wrapping around is harmless
+    global_curslot = -1;
+    for (int i=0; i<SAVESLOT_COUNT; i++)
+    {
+        GameSave* save = (GameSave*)global_saveslots[i];
+        if (!slot_isvalid(save))
+            continue;
+        if (global_curslot == -1 || (int32_t)(save->sequence - ((GameSave*)global_saveslots[global_curslot])->sequence) > 0)
+            global_curslot = i;
+    }
    
     // If the EEPROM hasn't been initialized before, do so now
-    if (strncmp(global_gamesave.header, "NBGJ", 4) != 0)
+    if (global_curslot == -1)
     {
         memset(&global_gamesave, 0, sizeof(GameSave));
-        global_gamesave.header[0] = 'N';
-        global_gamesave.header[1] = 'B';
-        global_gamesave.header[2] = 'G';
-        global_gamesave.header[3] = 'J';
-        global_gamesave.checksum = calc_checksum();
+        memcpy(global_gamesave.header, SAVE_HEADER, 4);
+        global_curslot = SAVESLOT_COUNT-1;
     }
+    else
+        memcpy(&global_gamesave, global_saveslots[global_curslot], sizeof(GameSave));
     
     // Success
     return true;
@@ -139,11 +225,10 @@ void savestate_save(bool configonly)
         global_gamesave.nextplaystyle = core_get_nextround();
         global_gamesave.chooser = core_get_curchooser();
         global_gamesave.curgame = minigame_get_index();
-        global_gamesave.checksum = calc_checksum();
     }
     
     // Save to EEPROM
-    eeprom_write_bytes((uint8_t*)(&global_gamesave), 0, sizeof(GameSave));
+    savestate_write();
 }
 
 
@@ -185,7 +270,7 @@ void savestate_clear()
     if (!global_cansave)
         return;
     global_gamesave.crashedflag = 0;
-    eeprom_write_bytes((uint8_t*)(&global_gamesave), 0, sizeof(GameSave));
+    savestate_write();
 }
 
 void savestate_setblacklist(bool* list)
@@ -64,12 +64,29 @@ typedef struct {
     int cornersize;
 } BoxSpriteDef;
 
+// The state a box's draw commands depend on
+typedef struct {
+    float w;
+    float h;
+    float x;
+    float y;
+    color_t col;
+} BoxState;
+
 typedef struct {
     float w;
     float h;
     float x;
     float y;
     BoxSpriteDef spr;
+
+    // Recorded draw commands, only rebuilt once the box stops changing
+    rspq_block_t* block;
+    BoxState blockstate;
+    BoxState laststate;
+    rspq_block_t* cullblock;
+    int cullrect[4];
+    int lastcullrect[4];
 } BoxDef;
 
 
@@ -106,6 +123,7 @@ static BoxDef* bdef_backbox_gameconfig;
 static BoxDef* bdef_backbox_blacklist;
 static BoxDef* bdef_button_freeplay;
 static BoxDef* bdef_button_compete;
+static rspq_block_t* global_progressblock;
 static sprite_t* spr_toybox;
 static sprite_t* spr_trophy;
 static sprite_t* spr_pointer;
@@ -133,6 +151,8 @@ static xm64player_t global_music;
 
 static void setup_draw(float deltatime);
 static void drawbox(BoxDef* bd, color_t col);
+static void drawbox_immediate(BoxDef* bd, color_t col);
+static void freebox(BoxDef* bd);
 static void drawprogress(int x, int y, color_t col);
 static void culledges(BoxDef* back);
 static void uncull(void);
@@ -300,13 +320,13 @@ void setup_init()
     global_cfg_blacklist = (bool*)malloc(sizeof(bool)*global_minigame_count);
     savestate_getblacklist(global_cfg_blacklist);
 
-    bdef_backbox_mode = (BoxDef*)malloc(sizeof(BoxDef));
-    bdef_backbox_plycount = (BoxDef*)malloc(sizeof(BoxDef));
-    bdef_backbox_gameconfig = (BoxDef*)malloc(sizeof(BoxDef));
-    bdef_backbox_aidiff = (BoxDef*)malloc(sizeof(BoxDef));
-    bdef_backbox_blacklist = (BoxDef*)malloc(sizeof(BoxDef));
-    bdef_button_freeplay = (BoxDef*)malloc(sizeof(BoxDef));
-    bdef_button_compete = (BoxDef*)malloc(sizeof(BoxDef));
+    bdef_backbox_mode = (BoxDef*)calloc(1, sizeof(BoxDef));
+    bdef_backbox_plycount = (BoxDef*)calloc(1, sizeof(BoxDef));
+    bdef_backbox_gameconfig = (BoxDef*)calloc(1, sizeof(BoxDef));
+    bdef_backbox_aidiff = (BoxDef*)calloc(1, sizeof(BoxDef));
+    bdef_backbox_blacklist = (BoxDef*)calloc(1, sizeof(BoxDef));
+    bdef_button_freeplay = (BoxDef*)calloc(1, sizeof(BoxDef));
+    bdef_button_compete = (BoxDef*)calloc(1, sizeof(BoxDef));
     spr_toybox = sprite_load("rom:/core/ToyBox.rgba32.sprite");
     spr_trophy = sprite_load("rom:/core/Trophy.rgba32.sprite");
     spr_pointer = sprite_load("rom:/core/Pointer.rgba32.sprite");
@@ -1037,13 +1057,16 @@ void setup_cleanup()
     rdpq_text_unregister_font(FONTDEF_XLARGE);
     rdpq_font_free(global_font1);
     rdpq_font_free(global_font2);
-    free(bdef_backbox_mode);
-    free(bdef_backbox_plycount);
-    free(bdef_backbox_aidiff);
-    free(bdef_backbox_gameconfig);
-    free(bdef_backbox_blacklist);
-    free(bdef_button_compete);
-    free(bdef_button_freeplay);
+    if (global_progressblock != NULL)
+        rspq_block_free(global_progressblock);
+    global_progressblock = NULL;
+    freebox(bdef_backbox_mode);
+    freebox(bdef_backbox_plycount);
+    freebox(bdef_backbox_aidiff);
+    freebox(bdef_backbox_gameconfig);
+    freebox(bdef_backbox_blacklist);
+    freebox(bdef_button_compete);
+    freebox(bdef_button_freeplay);
     wav64_close(&sfx_cursor);
     wav64_close(&sfx_confirm);
     wav64_close(&sfx_back);
@@ -1059,7 +1082,50 @@ void setup_cleanup()
 
 =============================================================*/
 
+static bool boxstate_equal(const BoxState* a, const BoxState* b)
+{
+    return a->w == b->w && a->h == b->h && a->x == b->x && a->y == b->y && color_to_packed32(a->col) == color_to_packed32(b->col);
+}
+
 static void drawbox(BoxDef* bd, color_t col)
+{
+    BoxState state = {bd->w, bd->h, bd->x, bd->y, col};
+
+    // Throw away the recorded commands if the box moved, resized or changed color
+    if (bd->block != NULL && !boxstate_equal(&state, &bd->blockstate))
+    {
+        rspq_block_free(bd->block);
+        bd->block = NULL;
+    }
+
+    // Boxes which are still animating are drawn immediately, as recording them every frame would cost more.
+    // Once a box has held still for a frame, record it so that the following frames just replay it
+    if (bd->block == NULL)
+    {
+        if (!boxstate_equal(&state, &bd->laststate))
+        {
+            bd->laststate = state;
+            drawbox_immediate(bd, col);
+            return;
+        }
+        rspq_block_begin();
+            drawbox_immediate(bd, col);
+        bd->block = rspq_block_end();
+        bd->blockstate = state;
+    }
+    rspq_block_run(bd->block);
+}
+
+static void freebox(BoxDef* bd)
+{
+    if (bd->block != NULL)
+        rspq_block_free(bd->block);
+    if (bd->cullblock != NULL)
+        rspq_block_free(bd->cullblock);
+    free(bd);
+}
+
+static void drawbox_immediate(BoxDef* bd, color_t col)
 {
     int w = bd->w;
     int h = bd->h;
@@ -1119,18 +1185,25 @@ static void drawbox(BoxDef* bd, color_t col)
 
 static void drawprogress(int x, int y, color_t col)
 {
-    rdpq_set_mode_standard();
-    rdpq_mode_blender(RDPQ_BLENDER_MULTIPLY);
-    rdpq_mode_combiner(RDPQ_COMBINER2(
-        (TEX1,0,PRIM,0),  (0,0,0,TEX0),
-        (0,0,0,COMBINED), (0,0,0,TEX1)
-    ));
+    // The mode and textures never change, only the color, position and alpha threshold do
+    if (global_progressblock == NULL)
+    {
+        rspq_block_begin();
+            rdpq_set_mode_standard();
+            rdpq_mode_blender(RDPQ_BLENDER_MULTIPLY);
+            rdpq_mode_combiner(RDPQ_COMBINER2(
+                (TEX1,0,PRIM,0),  (0,0,0,TEX0),
+                (0,0,0,COMBINED), (0,0,0,TEX1)
+            ));
+            rdpq_tex_multi_begin();
+                rdpq_sprite_upload(TILE0, spr_circlemask, NULL);
+                rdpq_sprite_upload(TILE1, spr_progress, NULL);
+            rdpq_tex_multi_end();
+        global_progressblock = rspq_block_end();
+    }
+    rspq_block_run(global_progressblock);
     rdpq_set_prim_color(col);
     rdpq_mode_alphacompare((1.0f-global_readyprog)*255.0f);
-    rdpq_tex_multi_begin();
-        rdpq_sprite_upload(TILE0, spr_circlemask, NULL);
-        rdpq_sprite_upload(TILE1, spr_progress, NULL);
-    rdpq_tex_multi_end();
     rdpq_texture_rectangle(TILE0, x, y, x+32, y+32, 0, 0);
     rdpq_set_mode_standard();
     rdpq_mode_blender(RDPQ_BLENDER_MULTIPLY);
@@ -1150,11 +1223,30 @@ static void culledges(BoxDef* back)
     if (boxbottom > 240) boxbottom = 240;
     if (boxright < boxleft) boxright = boxleft;
     if (boxbottom < boxtop) boxbottom = boxtop;
+    int rect[4] = {boxleft, boxtop, boxright, boxbottom};
 
-    rdpq_set_scissor(boxleft, boxtop, boxright, boxbottom);
-    rdpq_set_mode_standard();
-    rdpq_mode_blender(RDPQ_BLENDER_MULTIPLY);
-    rdpq_mode_combiner(RDPQ_COMBINER1((TEX0,0,PRIM,0), (TEX0,0,PRIM,0)));
+    // Same as drawbox, only record the scissor and mode once the rect has stopped changing
+    if (back->cullblock != NULL && memcmp(rect, back->cullrect, sizeof(rect)) != 0)
+    {
+        rspq_block_free(back->cullblock);
+        back->cullblock = NULL;
+    }
+    if (back->cullblock == NULL)
+    {
+        bool stable = (memcmp(rect, back->lastcullrect, sizeof(rect)) == 0);
+        memcpy(back->lastcullrect, rect, sizeof(rect));
+        if (stable)
+            rspq_block_begin();
+        rdpq_set_scissor(boxleft, boxtop, boxright, boxbottom);
+        rdpq_set_mode_standard();
+        rdpq_mode_blender(RDPQ_BLENDER_MULTIPLY);
+        rdpq_mode_combiner(RDPQ_COMBINER1((TEX0,0,PRIM,0), (TEX0,0,PRIM,0)));
+        if (!stable)
+            return;
+        back->cullblock = rspq_block_end();
+        memcpy(back->cullrect, rect, sizeof(rect));
+    }
+    rspq_block_run(back->cullblock);
 }
 
 static void uncull(void)
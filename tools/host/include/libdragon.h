@@ -0,0 +1,624 @@
+/***************************************************************
+                      host/include/libdragon.h
+
+A minimal stand-in for libdragon, used to build the core level
+system and minigame DSOs as native Linux code. Rendering, audio
+and asset loading are no-ops, time is simulated, and joypads are
+fed by the host runner.
+***************************************************************/
+
+#ifndef GAMEJAM2024_HOST_LIBDRAGON_H
+#define GAMEJAM2024_HOST_LIBDRAGON_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <math.h>
+#include <assert.h>
+#include <unistd.h>
+#include <dlfcn.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /***************************************************************
+                               System
+    ***************************************************************/
+
+    #define TICKS_PER_SECOND     (93750000/2)
+    #define TICKS_FROM_MS(val)   ((uint64_t)(val) * (TICKS_PER_SECOND / 1000))
+    #define TICKS_FROM_US(val)   ((uint64_t)(val) * (TICKS_PER_SECOND / 1000) / 1000)
+    #define TICKS_TO_MS(val)     ((uint64_t)(val) / (TICKS_PER_SECOND / 1000))
+    #define TICKS_TO_US(val)     ((uint64_t)(val) * 1000 / (TICKS_PER_SECOND / 1000))
+    #define TICKS_READ()         ((uint32_t)get_ticks())
+    #define TICKS_DISTANCE(a, b) ((int32_t)((b) - (a)))
+    #define TIMER_TICKS_LL(us)   ((long long)(us) * (TICKS_PER_SECOND / 1000) / 1000)
+    #define TIMER_MICROS_LL(tk)  ((long long)(tk) * 1000 / (TICKS_PER_SECOND / 1000))
+    #define TIMER_TICKS(us)      ((int)TIMER_TICKS_LL(us))
+    #define TIMER_MICROS(tk)     ((int)TIMER_MICROS_LL(tk))
+
+    typedef enum {
+        RESET_COLD,
+        RESET_WARM,
+    } reset_type_t;
+
+    typedef struct {
+        int total;
+        int used;
+    } heap_stats_t;
+
+    uint64_t     get_ticks(void);
+    uint64_t     get_ticks_ms(void);
+    uint64_t     get_ticks_us(void);
+    void         wait_ms(unsigned long ms);
+    void         timer_init(void);
+    reset_type_t sys_reset_type(void);
+    void         sys_get_heap_stats(heap_stats_t* stats);
+    void         register_VI_handler(void (*callback)(void));
+    void*        malloc_uncached(size_t size);
+    void*        malloc_uncached_aligned(int align, size_t size);
+    void         free_uncached(void* buf);
+    void         data_cache_hit_writeback(const void* addr, unsigned long length);
+    void         data_cache_hit_writeback_invalidate(const void* addr, unsigned long length);
+
+    #define UncachedAddr(addr)  ((void*)(addr))
+    #define CachedAddr(addr)    ((void*)(addr))
+
+    void debugf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+    void debug_init_isviewer(void);
+    void debug_init_usblog(void);
+
+    #define assertf(expr, msg, ...) do { \
+            if (!(expr)) { \
+                fprintf(stderr, "ASSERTION FAILED: %s\n%s:%d: " msg "\n", #expr, __FILE__, __LINE__, ##__VA_ARGS__); \
+                abort(); \
+            } \
+        } while (0)
+
+
+    /***************************************************************
+                               Math
+    ***************************************************************/
+
+    #define FM_PI  3.14159265358979f
+
+    static inline float fm_sinf(float x)                       { return sinf(x); }
+    static inline float fm_cosf(float x)                       { return cosf(x); }
+    static inline void  fm_sincosf(float x, float* s, float* c) { *s = sinf(x); *c = cosf(x); }
+    static inline float fm_atan2f(float y, float x)            { return atan2f(y, x); }
+    static inline float fm_fmodf(float x, float y)             { return fmodf(x, y); }
+    static inline float fm_floorf(float x)                     { return floorf(x); }
+    static inline float fm_ceilf(float x)                      { return ceilf(x); }
+    static inline float fm_truncf(float x)                     { return truncf(x); }
+    static inline float fm_exp(float x)                        { return expf(x); }
+    static inline float fm_lerp(float a, float b, float t)     { return a + (b - a)*t; }
+
+
+    /***************************************************************
+                           Filesystem/Assets
+    ***************************************************************/
+
+    #define DFS_DEFAULT_LOCATION  0
+
+    typedef struct {
+        char d_name[256];
+        int d_type;
+        int64_t d_size;
+        void* d_cookie;
+    } dir_t;
+
+    int   dfs_init(uint32_t base_fs_loc);
+    int   dir_findfirst(const char* path, dir_t* dir);
+    int   dir_findnext(const char* path, dir_t* dir);
+    void  asset_init_compression(int algo);
+    void* asset_load(const char* fn, int* sz);
+    FILE* asset_fopen(const char* fn, int* sz);
+
+    // libdragon's dynamic loader accepts "rom:/" paths and RTLD_LOCAL on its own
+    void* host_dlopen(const char* filename, int mode);
+    #define dlopen(filename, mode) host_dlopen(filename, mode)
+
+
+    /***************************************************************
+                               Graphics
+    ***************************************************************/
+
+    typedef struct {
+        uint8_t r, g, b, a;
+    } color_t;
+
+    #define RGBA32(rx, gx, bx, ax) ((color_t){.r=(rx), .g=(gx), .b=(bx), .a=(ax)})
+    #define RGBA16(rx, gx, bx, ax) ((color_t){.r=(uint8_t)((rx)<<3), .g=(uint8_t)((gx)<<3), .b=(uint8_t)((bx)<<3), .a=(uint8_t)((ax) ? 0xFF : 0)})
+
+    static inline color_t color_from_packed32(uint32_t c)
+    {
+        return (color_t){.r=(uint8_t)(c >> 24), .g=(uint8_t)(c >> 16), .b=(uint8_t)(c >> 8), .a=(uint8_t)c};
+    }
+
+    static inline uint32_t color_to_packed32(color_t c)
+    {
+        return ((uint32_t)c.r << 24) | ((uint32_t)c.g << 16) | ((uint32_t)c.b << 8) | c.a;
+    }
+
+    typedef enum {
+        FMT_NONE,
+        FMT_RGBA16,
+        FMT_RGBA32,
+        FMT_IA16,
+        FMT_CI4,
+        FMT_CI8,
+        FMT_IA4,
+        FMT_IA8,
+        FMT_I4,
+        FMT_I8,
+    } tex_format_t;
+
+    typedef struct {
+        uint16_t flags;
+        uint16_t width;
+        uint16_t height;
+        uint16_t stride;
+        void* buffer;
+    } surface_t;
+
+    typedef struct {
+        uint16_t width;
+        uint16_t height;
+        uint8_t flags;
+        uint8_t hslices;
+        uint8_t vslices;
+    } sprite_t;
+
+    typedef struct {
+        int32_t width;
+        int32_t height;
+        int interlaced;
+        float aspect_ratio;
+    } resolution_t;
+
+    #define RESOLUTION_256x240  ((resolution_t){.width=256, .height=240})
+    #define RESOLUTION_320x240  ((resolution_t){.width=320, .height=240})
+    #define RESOLUTION_512x240  ((resolution_t){.width=512, .height=240})
+    #define RESOLUTION_640x240  ((resolution_t){.width=640, .height=240})
+    #define RESOLUTION_512x480  ((resolution_t){.width=512, .height=480})
+    #define RESOLUTION_640x480  ((resolution_t){.width=640, .height=480})
+
+    typedef enum {
+        DEPTH_16_BPP,
+        DEPTH_32_BPP,
+    } bitdepth_t;
+
+    typedef enum {
+        GAMMA_NONE,
+        GAMMA_CORRECT,
+        GAMMA_CORRECT_DITHER,
+    } gamma_t;
+
+    typedef enum {
+        FILTERS_DISABLED,
+        FILTERS_RESAMPLE,
+        FILTERS_DEDITHER,
+        FILTERS_RESAMPLE_ANTIALIAS,
+        FILTERS_RESAMPLE_ANTIALIAS_DEDITHER,
+    } filter_options_t;
+
+    void       display_init(resolution_t res, bitdepth_t bit, uint32_t num_buffers, gamma_t gamma, filter_options_t filters);
+    void       display_close(void);
+    surface_t* display_get(void);
+    surface_t* display_try_get(void);
+    surface_t* display_get_zbuf(void);
+    void       display_show(surface_t* surf);
+    uint32_t   display_get_width(void);
+    uint32_t   display_get_height(void);
+    float      display_get_fps(void);
+    float      display_get_delta_time(void);
+    void       display_set_fps_limit(float fps);
+
+    sprite_t*  sprite_load(const char* fn);
+    void       sprite_free(sprite_t* sprite);
+    surface_t  sprite_get_pixels(sprite_t* sprite);
+
+
+    /***************************************************************
+                                RSPQ
+    ***************************************************************/
+
+    typedef struct rspq_block_s rspq_block_t;
+    typedef int rspq_syncpoint_t;
+
+    void             rspq_init(void);
+    void             rspq_flush(void);
+    void             rspq_wait(void);
+    void             rspq_block_begin(void);
+    rspq_block_t*    rspq_block_end(void);
+    void             rspq_block_run(rspq_block_t* block);
+    void             rspq_block_free(rspq_block_t* block);
+    rspq_syncpoint_t rspq_syncpoint_new(void);
+    bool             rspq_syncpoint_check(rspq_syncpoint_t sync_id);
+    void             rspq_syncpoint_wait(rspq_syncpoint_t sync_id);
+
+
+    /***************************************************************
+                                RDPQ
+    ***************************************************************/
+
+    typedef enum {
+        TILE0 = 0, TILE1, TILE2, TILE3, TILE4, TILE5, TILE6, TILE7,
+    } rdpq_tile_t;
+
+    typedef enum {
+        FILTER_POINT,
+        FILTER_BILINEAR,
+        FILTER_MEDIAN,
+    } rdpq_filter_t;
+
+    typedef enum {
+        DITHER_SQUARE_SQUARE,
+        DITHER_SQUARE_INVSQUARE,
+        DITHER_SQUARE_NOISE,
+        DITHER_SQUARE_NONE,
+        DITHER_BAYER_BAYER,
+        DITHER_BAYER_INVBAYER,
+        DITHER_BAYER_NOISE,
+        DITHER_BAYER_NONE,
+        DITHER_NOISE_SQUARE,
+        DITHER_NOISE_INVSQUARE,
+        DITHER_NOISE_NOISE,
+        DITHER_NOISE_NONE,
+        DITHER_NONE_BAYER,
+        DITHER_NONE_INVBAYER,
+        DITHER_NONE_NOISE,
+        DITHER_NONE_NONE,
+    } rdpq_dither_t;
+
+    // Combiner and blender formulas are only meaningful to the RDP, so they collapse to zero here
+    typedef uint64_t rdpq_combiner_t;
+    typedef uint32_t rdpq_blender_t;
+
+    #define RDPQ_COMBINER1(rgb, alpha)                   ((rdpq_combiner_t)0)
+    #define RDPQ_COMBINER2(rgb0, alpha0, rgb1, alpha1)   ((rdpq_combiner_t)0)
+    #define RDPQ_COMBINER_FLAT       ((rdpq_combiner_t)0)
+    #define RDPQ_COMBINER_SHADE      ((rdpq_combiner_t)0)
+    #define RDPQ_COMBINER_TEX        ((rdpq_combiner_t)0)
+    #define RDPQ_COMBINER_TEX_FLAT   ((rdpq_combiner_t)0)
+    #define RDPQ_COMBINER_TEX_SHADE  ((rdpq_combiner_t)0)
+    #define RDPQ_BLENDER(bl)         ((rdpq_blender_t)0)
+    #define RDPQ_BLENDER2(bl0, bl1)  ((rdpq_blender_t)0)
+    #define RDPQ_BLENDER_MULTIPLY        ((rdpq_blender_t)0)
+    #define RDPQ_BLENDER_MULTIPLY_CONST  ((rdpq_blender_t)0)
+    #define RDPQ_BLENDER_ADDITIVE        ((rdpq_blender_t)0)
+
+    #define REPEAT_INFINITE  2048
+
+    typedef struct {
+        int tmem_addr;
+        int palette;
+        struct {
+            float translate;
+            int scale_log;
+            float repeats;
+            bool mirror;
+        } s, t;
+    } rdpq_texparms_t;
+
+    typedef struct {
+        rdpq_tile_t tile;
+        int s0;
+        int t0;
+        int width;
+        int height;
+        bool flip_x;
+        bool flip_y;
+        int cx;
+        int cy;
+        float scale_x;
+        float scale_y;
+        float theta;
+        bool filtering;
+        int nx;
+        int ny;
+    } rdpq_blitparms_t;
+
+    void rdpq_init(void);
+    void rdpq_close(void);
+    void rdpq_attach(const surface_t* surf_color, const surface_t* surf_z);
+    void rdpq_attach_clear(const surface_t* surf_color, const surface_t* surf_z);
+    void rdpq_detach(void);
+    void rdpq_detach_wait(void);
+    void rdpq_detach_show(void);
+    void rdpq_clear(color_t color);
+    void rdpq_clear_z(uint16_t z);
+    void rdpq_sync_pipe(void);
+    void rdpq_sync_tile(void);
+    void rdpq_sync_load(void);
+    void rdpq_sync_full(void (*callback)(void*), void* arg);
+    void rdpq_set_mode_standard(void);
+    void rdpq_set_mode_copy(bool transparency);
+    void rdpq_set_mode_fill(color_t color);
+    void rdpq_mode_begin(void);
+    void rdpq_mode_end(void);
+    void rdpq_mode_push(void);
+    void rdpq_mode_pop(void);
+    void rdpq_mode_combiner(rdpq_combiner_t comb);
+    void rdpq_mode_blender(rdpq_blender_t blend);
+    void rdpq_mode_alphacompare(int threshold);
+    void rdpq_mode_filter(rdpq_filter_t filt);
+    void rdpq_mode_dithering(rdpq_dither_t dither);
+    void rdpq_mode_zbuf(bool compare, bool update);
+    void rdpq_mode_antialias(int mode);
+    void rdpq_mode_persp(bool perspective);
+    void rdpq_set_prim_color(color_t color);
+    void rdpq_set_env_color(color_t color);
+    void rdpq_set_blend_color(color_t color);
+    void rdpq_set_fog_color(color_t color);
+    void rdpq_set_fill_color(color_t color);
+    void rdpq_set_scissor(int x0, int y0, int x1, int y1);
+    void rdpq_fill_rectangle(float x0, float y0, float x1, float y1);
+    void rdpq_texture_rectangle(rdpq_tile_t tile, float x0, float y0, float x1, float y1, float s, float t);
+    void rdpq_texture_rectangle_scaled(rdpq_tile_t tile, float x0, float y0, float x1, float y1, float s0, float t0, float s1, float t1);
+    void rdpq_tex_multi_begin(void);
+    int  rdpq_tex_multi_end(void);
+    int  rdpq_sprite_upload(rdpq_tile_t tile, sprite_t* sprite, const rdpq_texparms_t* parms);
+    int  rdpq_tex_upload(rdpq_tile_t tile, const surface_t* tex, const rdpq_texparms_t* parms);
+    void rdpq_tex_reuse_sub(rdpq_tile_t tile, const rdpq_texparms_t* parms, int s0, int t0, int s1, int t1);
+    void rdpq_sprite_blit(sprite_t* sprite, float x0, float y0, const rdpq_blitparms_t* parms);
+    void rdpq_tex_blit(const surface_t* surf, float x0, float y0, const rdpq_blitparms_t* parms);
+    void rdpq_debug_start(void);
+    void rdpq_debug_log(bool log);
+
+
+    /***************************************************************
+                             RDPQ Text
+    ***************************************************************/
+
+    typedef struct rdpq_font_s rdpq_font_t;
+
+    typedef enum {
+        FONT_BUILTIN_DEBUG_MONO = 1,
+        FONT_BUILTIN_DEBUG_VAR = 2,
+    } rdpq_font_builtin_t;
+
+    typedef enum {
+        ALIGN_LEFT = 0,
+        ALIGN_CENTER = 1,
+        ALIGN_RIGHT = 2,
+    } rdpq_align_t;
+
+    typedef enum {
+        VALIGN_TOP = 0,
+        VALIGN_CENTER = 1,
+        VALIGN_BOTTOM = 2,
+    } rdpq_valign_t;
+
+    typedef enum {
+        WRAP_NONE = 0,
+        WRAP_ELLIPSES = 1,
+        WRAP_CHAR = 2,
+        WRAP_WORD = 3,
+    } rdpq_textwrap_t;
+
+    typedef struct {
+        color_t color;
+        color_t outline_color;
+    } rdpq_fontstyle_t;
+
+    typedef struct {
+        int16_t width;
+        int16_t height;
+        rdpq_align_t align;
+        rdpq_valign_t valign;
+        int16_t indent;
+        int16_t max_chars;
+        int16_t char_spacing;
+        int16_t line_spacing;
+        rdpq_textwrap_t wrap;
+        int16_t* tabstops;
+        uint8_t style_id;
+        bool disable_aa_fix;
+        bool preserve_overlap;
+    } rdpq_textparms_t;
+
+    typedef struct {
+        float advance_x;
+        float advance_y;
+        int utf8_text_advance;
+        int nlines;
+    } rdpq_textmetrics_t;
+
+    rdpq_font_t*       rdpq_font_load(const char* fn);
+    rdpq_font_t*       rdpq_font_load_builtin(rdpq_font_builtin_t font);
+    void               rdpq_font_free(rdpq_font_t* fnt);
+    void               rdpq_font_style(rdpq_font_t* font, uint8_t style_id, const rdpq_fontstyle_t* style);
+    void               rdpq_text_register_font(uint8_t font_id, const rdpq_font_t* font);
+    void               rdpq_text_unregister_font(uint8_t font_id);
+    rdpq_textmetrics_t rdpq_text_print(const rdpq_textparms_t* parms, uint8_t font_id, float x0, float y0, const char* utf8_text);
+    rdpq_textmetrics_t rdpq_text_printn(const rdpq_textparms_t* parms, uint8_t font_id, float x0, float y0, const char* utf8_text, int nbytes);
+    rdpq_textmetrics_t rdpq_text_printf(const rdpq_textparms_t* parms, uint8_t font_id, float x0, float y0, const char* utf8_fmt, ...) __attribute__((format(printf, 5, 6)));
+
+
+    /***************************************************************
+                               Joypad
+    ***************************************************************/
+
+    typedef enum {
+        JOYPAD_PORT_1 = 0,
+        JOYPAD_PORT_2 = 1,
+        JOYPAD_PORT_3 = 2,
+        JOYPAD_PORT_4 = 3,
+    } joypad_port_t;
+
+    #define JOYPAD_PORT_COUNT  4
+    #define JOYPAD_PORT_FOREACH(iter) for (joypad_port_t iter = JOYPAD_PORT_1; iter < JOYPAD_PORT_COUNT; ++iter)
+
+    typedef enum {
+        JOYPAD_STYLE_NONE = 0,
+        JOYPAD_STYLE_N64,
+        JOYPAD_STYLE_GCN,
+        JOYPAD_STYLE_MOUSE,
+    } joypad_style_t;
+
+    typedef enum {
+        JOYPAD_AXIS_STICK_X,
+        JOYPAD_AXIS_STICK_Y,
+        JOYPAD_AXIS_CSTICK_X,
+        JOYPAD_AXIS_CSTICK_Y,
+        JOYPAD_AXIS_ANALOG_L,
+        JOYPAD_AXIS_ANALOG_R,
+    } joypad_axis_t;
+
+    typedef enum {
+        JOYPAD_2D_DPAD,
+        JOYPAD_2D_STICK,
+        JOYPAD_2D_CSTICK,
+        JOYPAD_2D_LH,
+        JOYPAD_2D_RH,
+        JOYPAD_2D_LR,
+        JOYPAD_2D_ANY,
+    } joypad_2d_t;
+
+    typedef enum {
+        JOYPAD_8WAY_NONE = 0,
+        JOYPAD_8WAY_RIGHT,
+        JOYPAD_8WAY_UP_RIGHT,
+        JOYPAD_8WAY_UP,
+        JOYPAD_8WAY_UP_LEFT,
+        JOYPAD_8WAY_LEFT,
+        JOYPAD_8WAY_DOWN_LEFT,
+        JOYPAD_8WAY_DOWN,
+        JOYPAD_8WAY_DOWN_RIGHT,
+    } joypad_8way_t;
+
+    typedef union {
+        uint16_t raw;
+        struct __attribute__((packed)) {
+            unsigned a : 1;
+            unsigned b : 1;
+            unsigned z : 1;
+            unsigned start : 1;
+            unsigned d_up : 1;
+            unsigned d_down : 1;
+            unsigned d_left : 1;
+            unsigned d_right : 1;
+            unsigned y : 1;
+            unsigned x : 1;
+            unsigned l : 1;
+            unsigned r : 1;
+            unsigned c_up : 1;
+            unsigned c_down : 1;
+            unsigned c_left : 1;
+            unsigned c_right : 1;
+        };
+    } joypad_buttons_t;
+
+    typedef struct {
+        joypad_buttons_t btn;
+        int8_t stick_x;
+        int8_t stick_y;
+        int8_t cstick_x;
+        int8_t cstick_y;
+        uint8_t analog_l;
+        uint8_t analog_r;
+    } joypad_inputs_t;
+
+    void             joypad_init(void);
+    void             joypad_close(void);
+    void             joypad_poll(void);
+    bool             joypad_is_connected(joypad_port_t port);
+    joypad_style_t   joypad_get_style(joypad_port_t port);
+    joypad_inputs_t  joypad_get_inputs(joypad_port_t port);
+    joypad_buttons_t joypad_get_buttons(joypad_port_t port);
+    joypad_buttons_t joypad_get_buttons_pressed(joypad_port_t port);
+    joypad_buttons_t joypad_get_buttons_released(joypad_port_t port);
+    joypad_buttons_t joypad_get_buttons_held(joypad_port_t port);
+    joypad_8way_t    joypad_get_direction(joypad_port_t port, joypad_2d_t axes);
+    int              joypad_get_axis_pressed(joypad_port_t port, joypad_axis_t axis);
+    int              joypad_get_axis_released(joypad_port_t port, joypad_axis_t axis);
+    int              joypad_get_axis_held(joypad_port_t port, joypad_axis_t axis);
+    void             joypad_set_rumble_active(joypad_port_t port, bool active);
+    bool             joypad_get_rumble_supported(joypad_port_t port);
+
+
+    /***************************************************************
+                               Audio
+    ***************************************************************/
+
+    typedef struct {
+        const char* name;
+        int bits;
+        int channels;
+        float frequency;
+        int len;
+        int loop_len;
+    } waveform_t;
+
+    typedef struct {
+        waveform_t wave;
+        int format;
+    } wav64_t;
+
+    // Length assumed for every XM module, since the file is never parsed
+    #define HOST_XM64_DURATION  120.0f
+
+    typedef struct {
+        int first_ch;
+        int nch;
+        bool playing;
+        bool looping;
+        float volume;
+        uint64_t start_ticks;
+    } xm64player_t;
+
+    typedef struct {
+        float left;
+        float right;
+    } mixer_ch_vol_t;
+
+    void audio_init(int frequency, int numbuffers);
+    void audio_close(void);
+    void mixer_init(int num_channels);
+    void mixer_close(void);
+    void mixer_try_play(void);
+    void mixer_set_vol(float vol);
+    void mixer_ch_set_vol(int ch, float lvol, float rvol);
+    void mixer_ch_set_freq(int ch, float frequency);
+    void mixer_ch_set_limits(int ch, int max_bits, float max_frequency, int max_buf_sz);
+    void mixer_ch_stop(int ch);
+    bool mixer_ch_playing(int ch);
+
+    void wav64_open(wav64_t* wav, const char* fn);
+    wav64_t* wav64_load(const char* fn, void* parms);
+    void wav64_play(wav64_t* wav, int ch);
+    void wav64_set_loop(wav64_t* wav, bool loop);
+    void wav64_close(wav64_t* wav);
+
+    void xm64player_open(xm64player_t* player, const char* fn);
+    void xm64player_play(xm64player_t* player, int first_ch);
+    void xm64player_stop(xm64player_t* player);
+    void xm64player_close(xm64player_t* player);
+    void xm64player_set_loop(xm64player_t* player, bool loop);
+    void xm64player_set_vol(xm64player_t* player, float volume);
+    void xm64player_seek(xm64player_t* player, int patidx, int row, int tick);
+    int  xm64player_num_channels(xm64player_t* player);
+
+
+    /***************************************************************
+                          Host Runtime Hooks
+               Only used by the host runner, not by games
+    ***************************************************************/
+
+    void host_set_romdir(const char* path);
+    void host_set_verbose(bool verbose);
+    void host_set_joypad(joypad_port_t port, joypad_inputs_t inputs);
+    void host_advance_time(float deltatime);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
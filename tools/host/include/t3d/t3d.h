@@ -0,0 +1,70 @@
+/***************************************************************
+                       host/include/t3d/t3d.h
+
+Host stand-in for Tiny3D. Everything that would touch the RSP is
+a no-op, the viewport only keeps enough state for screen-space
+projections to return something sane.
+***************************************************************/
+
+#ifndef GAMEJAM2024_HOST_T3D_H
+#define GAMEJAM2024_HOST_T3D_H
+
+#include <libdragon.h>
+#include "t3dmath.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    #define T3D_FLAG_DEPTH      (1 << 0)
+    #define T3D_FLAG_TEXTURED   (1 << 1)
+    #define T3D_FLAG_SHADED     (1 << 2)
+    #define T3D_FLAG_CULL_FRONT (1 << 3)
+    #define T3D_FLAG_CULL_BACK  (1 << 4)
+    #define T3D_FLAG_NO_LIGHT   (1 << 5)
+
+    typedef struct {
+        int matrixStackSize;
+    } T3DInitParams;
+
+    typedef struct {
+        T3DMat4 matCamera;
+        T3DMat4 matProj;
+        T3DVec3 camPos;
+        T3DVec3 camTarget;
+        float fov;
+        float near;
+        float far;
+        int offset[2];
+        int size[2];
+    } T3DViewport;
+
+    void        t3d_init(T3DInitParams params);
+    void        t3d_destroy(void);
+    void        t3d_frame_start(void);
+    void        t3d_screen_clear_color(color_t color);
+    void        t3d_screen_clear_depth(void);
+    void        t3d_state_set_drawflags(int drawFlags);
+    void        t3d_light_set_ambient(const uint8_t* color);
+    void        t3d_light_set_directional(int index, const uint8_t* color, const T3DVec3* dir);
+    void        t3d_light_set_point(int index, const uint8_t* color, const T3DVec3* pos, float size, bool ignoreNormals);
+    void        t3d_light_set_count(int count);
+    void        t3d_fog_set_enabled(bool isEnabled);
+    void        t3d_fog_set_range(float near, float far);
+    void        t3d_matrix_push(const T3DMat4FP* mat);
+    void        t3d_matrix_pop(int count);
+    void        t3d_matrix_set(const T3DMat4FP* mat, bool doMultiply);
+    void        t3d_matrix_push_pos(int count);
+
+    T3DViewport t3d_viewport_create(void);
+    void        t3d_viewport_attach(T3DViewport* viewport);
+    void        t3d_viewport_set_area(T3DViewport* viewport, int x, int y, int width, int height);
+    void        t3d_viewport_set_projection(T3DViewport* viewport, float fov, float near, float far);
+    void        t3d_viewport_look_at(T3DViewport* viewport, const T3DVec3* eye, const T3DVec3* target, const T3DVec3* up);
+    void        t3d_viewport_calc_viewspace_pos(T3DViewport* viewport, T3DVec3* out, const T3DVec3* pos);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
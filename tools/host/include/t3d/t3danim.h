@@ -0,0 +1,45 @@
+/***************************************************************
+                     host/include/t3d/t3danim.h
+
+Host stand-in for Tiny3D animations. No keyframes are sampled,
+but playback time is tracked so that one-shot animations finish
+and games waiting on 'isPlaying' keep progressing.
+***************************************************************/
+
+#ifndef GAMEJAM2024_HOST_T3DANIM_H
+#define GAMEJAM2024_HOST_T3DANIM_H
+
+#include "t3dskeleton.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // Length assumed for every animation, since the model data is never loaded
+    #define HOST_T3D_ANIM_DURATION  1.0f
+
+    typedef struct {
+        const T3DModel* animRef;
+        T3DSkeleton* skel;
+        float time;
+        float speed;
+        float duration;
+        bool isPlaying;
+        bool isLooping;
+    } T3DAnim;
+
+    T3DAnim t3d_anim_create(const T3DModel* model, const char* name);
+    void    t3d_anim_attach(T3DAnim* anim, const T3DSkeleton* skeleton);
+    void    t3d_anim_update(T3DAnim* anim, float deltaTime);
+    void    t3d_anim_set_time(T3DAnim* anim, float time);
+    void    t3d_anim_destroy(T3DAnim* anim);
+
+    static inline void t3d_anim_set_speed(T3DAnim* anim, float speed)      { anim->speed = speed; }
+    static inline void t3d_anim_set_playing(T3DAnim* anim, bool isPlaying) { anim->isPlaying = isPlaying; }
+    static inline void t3d_anim_set_looping(T3DAnim* anim, bool loop)      { anim->isLooping = loop; }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
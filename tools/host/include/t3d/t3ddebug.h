@@ -0,0 +1,25 @@
+/***************************************************************
+                    host/include/t3d/t3ddebug.h
+
+Host stand-in for Tiny3D's debug text printer.
+***************************************************************/
+
+#ifndef GAMEJAM2024_HOST_T3DDEBUG_H
+#define GAMEJAM2024_HOST_T3DDEBUG_H
+
+#include "t3d.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    void t3d_debug_print_init(void);
+    void t3d_debug_print_start(void);
+    void t3d_debug_print(float x, float y, const char* str);
+    void t3d_debug_printf(float x, float y, const char* fmt, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
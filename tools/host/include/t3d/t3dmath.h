@@ -0,0 +1,195 @@
+/***************************************************************
+                     host/include/t3d/t3dmath.h
+
+Host stand-in for Tiny3D's math header. Vector helpers are real
+since game logic depends on them, fixed-point matrices are only
+kept as storage.
+***************************************************************/
+
+#ifndef GAMEJAM2024_HOST_T3DMATH_H
+#define GAMEJAM2024_HOST_T3DMATH_H
+
+#include <libdragon.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    #define T3D_PI             3.14159265358979f
+    #define T3D_DEG_TO_RAD(deg) ((deg) * (T3D_PI / 180.0f))
+
+    typedef union {
+        float v[3];
+        struct { float x, y, z; };
+    } T3DVec3;
+
+    typedef union {
+        float v[4];
+        struct { float x, y, z, w; };
+    } T3DVec4;
+
+    typedef T3DVec4 T3DQuat;
+
+    typedef struct {
+        float m[4][4];
+    } T3DMat4;
+
+    typedef struct {
+        int16_t i[4][4];
+        uint16_t f[4][4];
+    } T3DMat4FP;
+
+    static inline float t3d_lerp(float a, float b, float t)
+    {
+        return a + (b - a) * t;
+    }
+
+    static inline float t3d_lerp_angle(float a, float b, float t)
+    {
+        float diff = fmodf(b - a, T3D_PI*2.0f);
+        float dist = fmodf(diff*2.0f, T3D_PI*2.0f) - diff;
+        return a + dist * t;
+    }
+
+    static inline float t3d_vec3_dot(const T3DVec3* a, const T3DVec3* b)
+    {
+        return a->v[0]*b->v[0] + a->v[1]*b->v[1] + a->v[2]*b->v[2];
+    }
+
+    static inline float t3d_vec3_len2(const T3DVec3* v)
+    {
+        return t3d_vec3_dot(v, v);
+    }
+
+    static inline float t3d_vec3_len(const T3DVec3* v)
+    {
+        return sqrtf(t3d_vec3_len2(v));
+    }
+
+    static inline float t3d_vec3_distance2(const T3DVec3* a, const T3DVec3* b)
+    {
+        T3DVec3 d = {{b->v[0]-a->v[0], b->v[1]-a->v[1], b->v[2]-a->v[2]}};
+        return t3d_vec3_len2(&d);
+    }
+
+    static inline float t3d_vec3_distance(const T3DVec3* a, const T3DVec3* b)
+    {
+        return sqrtf(t3d_vec3_distance2(a, b));
+    }
+
+    static inline void t3d_vec3_norm(T3DVec3* v)
+    {
+        float len = t3d_vec3_len(v);
+        if (len < 0.0001f)
+            len = 0.0001f;
+        v->v[0] /= len;
+        v->v[1] /= len;
+        v->v[2] /= len;
+    }
+
+    static inline void t3d_vec3_add(T3DVec3* res, const T3DVec3* a, const T3DVec3* b)
+    {
+        for (int i=0; i<3; i++)
+            res->v[i] = a->v[i] + b->v[i];
+    }
+
+    static inline void t3d_vec3_diff(T3DVec3* res, const T3DVec3* a, const T3DVec3* b)
+    {
+        for (int i=0; i<3; i++)
+            res->v[i] = a->v[i] - b->v[i];
+    }
+
+    static inline void t3d_vec3_mul(T3DVec3* res, const T3DVec3* a, const T3DVec3* b)
+    {
+        for (int i=0; i<3; i++)
+            res->v[i] = a->v[i] * b->v[i];
+    }
+
+    static inline void t3d_vec3_scale(T3DVec3* res, const T3DVec3* a, float s)
+    {
+        for (int i=0; i<3; i++)
+            res->v[i] = a->v[i] * s;
+    }
+
+    static inline void t3d_vec3_lerp(T3DVec3* res, const T3DVec3* a, const T3DVec3* b, float t)
+    {
+        for (int i=0; i<3; i++)
+            res->v[i] = t3d_lerp(a->v[i], b->v[i], t);
+    }
+
+    static inline void t3d_vec3_cross(T3DVec3* res, const T3DVec3* a, const T3DVec3* b)
+    {
+        T3DVec3 tmp = {{
+            a->v[1]*b->v[2] - a->v[2]*b->v[1],
+            a->v[2]*b->v[0] - a->v[0]*b->v[2],
+            a->v[0]*b->v[1] - a->v[1]*b->v[0]
+        }};
+        *res = tmp;
+    }
+
+    static inline void t3d_mat4_identity(T3DMat4* mat)
+    {
+        for (int i=0; i<4; i++)
+            for (int j=0; j<4; j++)
+                mat->m[i][j] = (i == j) ? 1.0f : 0.0f;
+    }
+
+    static inline void t3d_mat4_to_fixed(T3DMat4FP* matOut, const T3DMat4* matIn)
+    {
+        (void)matOut;
+        (void)matIn;
+    }
+
+    static inline void t3d_mat4_from_srt_euler(T3DMat4* mat, const float scale[3], const float rot[3], const float translate[3])
+    {
+        (void)scale;
+        (void)rot;
+        t3d_mat4_identity(mat);
+        mat->m[3][0] = translate[0];
+        mat->m[3][1] = translate[1];
+        mat->m[3][2] = translate[2];
+    }
+
+    static inline void t3d_mat4fp_from_srt_euler(T3DMat4FP* mat, const float scale[3], const float rot[3], const float translate[3])
+    {
+        (void)mat;
+        (void)scale;
+        (void)rot;
+        (void)translate;
+    }
+
+    static inline void t3d_mat4fp_from_srt(T3DMat4FP* mat, const float scale[3], const float rotQuat[4], const float translate[3])
+    {
+        (void)mat;
+        (void)scale;
+        (void)rotQuat;
+        (void)translate;
+    }
+
+#ifdef __cplusplus
+}
+
+// Tiny3D's C++ convenience overloads
+inline T3DVec3 operator+(const T3DVec3& a, const T3DVec3& b) { return {{a.v[0]+b.v[0], a.v[1]+b.v[1], a.v[2]+b.v[2]}}; }
+inline T3DVec3 operator-(const T3DVec3& a, const T3DVec3& b) { return {{a.v[0]-b.v[0], a.v[1]-b.v[1], a.v[2]-b.v[2]}}; }
+inline T3DVec3 operator*(const T3DVec3& a, const T3DVec3& b) { return {{a.v[0]*b.v[0], a.v[1]*b.v[1], a.v[2]*b.v[2]}}; }
+inline T3DVec3 operator*(const T3DVec3& a, float s)          { return {{a.v[0]*s, a.v[1]*s, a.v[2]*s}}; }
+inline T3DVec3 operator/(const T3DVec3& a, float s)          { return a * (1.0f / s); }
+inline T3DVec3 operator-(const T3DVec3& a)                   { return {{-a.v[0], -a.v[1], -a.v[2]}}; }
+inline T3DVec3& operator+=(T3DVec3& a, const T3DVec3& b)     { return a = a + b; }
+inline T3DVec3& operator-=(T3DVec3& a, const T3DVec3& b)     { return a = a - b; }
+inline T3DVec3& operator*=(T3DVec3& a, float s)              { return a = a * s; }
+inline T3DVec3& operator/=(T3DVec3& a, float s)              { return a = a / s; }
+
+inline float t3d_vec3_dot(const T3DVec3& a, const T3DVec3& b)       { return t3d_vec3_dot(&a, &b); }
+inline float t3d_vec3_len2(const T3DVec3& v)                        { return t3d_vec3_len2(&v); }
+inline float t3d_vec3_len(const T3DVec3& v)                         { return t3d_vec3_len(&v); }
+inline float t3d_vec3_distance2(const T3DVec3& a, const T3DVec3& b) { return t3d_vec3_distance2(&a, &b); }
+inline float t3d_vec3_distance(const T3DVec3& a, const T3DVec3& b)  { return t3d_vec3_distance(&a, &b); }
+inline void  t3d_vec3_norm(T3DVec3& v)                              { t3d_vec3_norm(&v); }
+#endif
+
+#endif
@@ -0,0 +1,41 @@
+/***************************************************************
+                    host/include/t3d/t3dmodel.h
+
+Host stand-in for Tiny3D models. Models are never read from disk,
+loading returns an empty handle that can be drawn and freed.
+***************************************************************/
+
+#ifndef GAMEJAM2024_HOST_T3DMODEL_H
+#define GAMEJAM2024_HOST_T3DMODEL_H
+
+#include "t3d.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    typedef struct T3DSkeleton T3DSkeleton;
+
+    typedef struct {
+        const char* name;
+        uint32_t numParts;
+        bool isVisible;
+    } T3DObject;
+
+    typedef struct {
+        char* path;
+        uint32_t chunkCount;
+    } T3DModel;
+
+    T3DModel*  t3d_model_load(const char* path);
+    void       t3d_model_free(T3DModel* model);
+    void       t3d_model_draw(const T3DModel* model);
+    void       t3d_model_draw_skinned(const T3DModel* model, const T3DSkeleton* skeleton);
+    T3DObject* t3d_model_get_object(const T3DModel* model, const char* name);
+    void       t3d_model_draw_object(const T3DObject* object, const T3DMat4FP* boneMatrices);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
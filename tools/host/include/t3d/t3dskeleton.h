@@ -0,0 +1,36 @@
+/***************************************************************
+                   host/include/t3d/t3dskeleton.h
+
+Host stand-in for Tiny3D skeletons. Skeletons carry no bones,
+updates and blends are no-ops.
+***************************************************************/
+
+#ifndef GAMEJAM2024_HOST_T3DSKELETON_H
+#define GAMEJAM2024_HOST_T3DSKELETON_H
+
+#include "t3dmodel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    struct T3DSkeleton {
+        const T3DModel* skeletonRef;
+        T3DMat4FP* boneMatricesFP;
+        int boneCount;
+    };
+
+    T3DSkeleton t3d_skeleton_create(const T3DModel* model);
+    T3DSkeleton t3d_skeleton_create_buffered(const T3DModel* model, int bufferCount);
+    T3DSkeleton t3d_skeleton_clone(const T3DSkeleton* skel, bool useMatrices);
+    void        t3d_skeleton_update(T3DSkeleton* skel);
+    void        t3d_skeleton_blend(const T3DSkeleton* skelRes, const T3DSkeleton* skelA, const T3DSkeleton* skelB, float factor);
+    void        t3d_skeleton_reset(T3DSkeleton* skel);
+    void        t3d_skeleton_destroy(T3DSkeleton* skel);
+    int         t3d_skeleton_find_bone(T3DSkeleton* skel, const char* name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,31 @@
+/***************************************************************
+                          levels_stub.c
+
+The menu levels that core_initlevels registers. The host runner
+only ever enters LEVEL_MINIGAME, so these exist to satisfy the
+linker and do nothing.
+***************************************************************/
+
+#include <libdragon.h>
+#include "core.h"
+#include "setup.h"
+#include "menu.h"
+#include "results.h"
+#include "savestate.h"
+#include "title.h"
+
+void loadsave_init()                   {}
+void loadsave_loop(float deltatime)    { (void)deltatime; }
+void loadsave_cleanup()                {}
+void titlescreen_init()                {}
+void titlescreen_loop(float deltatime) { (void)deltatime; }
+void titlescreen_cleanup()             {}
+void setup_init()                      {}
+void setup_loop(float deltatime)       { (void)deltatime; }
+void setup_cleanup()                   {}
+void menu_init()                       {}
+void menu_loop(float deltatime)        { (void)deltatime; }
+void menu_cleanup()                    {}
+void results_init()                    {}
+void results_loop(float deltatime)     { (void)deltatime; }
+void results_cleanup()                 {}
@@ -0,0 +1,576 @@
+/***************************************************************
+                        libdragon_stub.c
+
+Host implementation of the libdragon subset declared in
+include/libdragon.h. Rendering and audio calls are swallowed,
+"rom:/" paths are redirected to a directory on the host and
+time only advances when the runner says so.
+***************************************************************/
+
+#include <libdragon.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <malloc.h>
+
+
+/*********************************
+             Globals
+*********************************/
+
+// Filesystem info
+static char global_host_romdir[512] = "build/filesystem/";
+
+// Time info, starting one second after "boot" since some games treat a tick count of zero as unset
+static uint64_t global_host_ticks = TICKS_PER_SECOND;
+static float    global_host_deltatime = 1.0f/30.0f;
+
+// Debug info
+static bool global_host_verbose = false;
+
+// Joypad info
+static joypad_inputs_t global_host_joypad_next[JOYPAD_PORT_COUNT];
+static joypad_inputs_t global_host_joypad_cur[JOYPAD_PORT_COUNT];
+static joypad_inputs_t global_host_joypad_prev[JOYPAD_PORT_COUNT];
+
+// Audio info
+#define HOST_MAX_XM64PLAYERS  8
+static xm64player_t* global_host_xm64players[HOST_MAX_XM64PLAYERS];
+
+// Rendering info
+static surface_t global_host_surface = {.width = 320, .height = 240, .stride = 640};
+static int       global_host_syncpoint = 0;
+
+struct rspq_block_s {
+    int dummy;
+};
+
+struct rdpq_font_s {
+    rdpq_fontstyle_t styles[16];
+};
+
+
+/*==============================
+    host_romfile
+    Converts a "rom:/" path into a host path
+    @param  The buffer to write the path to
+    @param  The size of the buffer
+    @param  The path to convert
+==============================*/
+
+static void host_romfile(char* out, size_t outsize, const char* path)
+{
+    if (!strncmp(path, "rom:/", 5))
+        snprintf(out, outsize, "%s/%s", global_host_romdir, path + 5);
+    else
+        snprintf(out, outsize, "%s", path);
+}
+
+
+/*==============================
+    host_set_romdir
+    Sets the host directory that stands in for "rom:/"
+    @param  The directory path
+==============================*/
+
+void host_set_romdir(const char* path)
+{
+    snprintf(global_host_romdir, sizeof(global_host_romdir), "%s", path);
+}
+
+
+/*==============================
+    host_set_verbose
+    Enables or disables debugf output
+    @param  Whether debugf should print to stderr
+==============================*/
+
+void host_set_verbose(bool verbose)
+{
+    global_host_verbose = verbose;
+}
+
+
+/*==============================
+    host_set_joypad
+    Sets the inputs that the next joypad_poll will report
+    @param  The controller port
+    @param  The inputs for that port
+==============================*/
+
+void host_set_joypad(joypad_port_t port, joypad_inputs_t inputs)
+{
+    global_host_joypad_next[port] = inputs;
+}
+
+
+/*==============================
+    host_advance_time
+    Moves the simulated clock forward
+    @param  The amount of seconds to advance
+==============================*/
+
+void host_advance_time(float deltatime)
+{
+    global_host_deltatime = deltatime;
+    global_host_ticks += (uint64_t)((double)deltatime * TICKS_PER_SECOND);
+}
+
+
+/*********************************
+             System
+*********************************/
+
+uint64_t get_ticks(void)          { return global_host_ticks; }
+uint64_t get_ticks_ms(void)       { return TICKS_TO_MS(global_host_ticks); }
+uint64_t get_ticks_us(void)       { return TICKS_TO_US(global_host_ticks); }
+void wait_ms(unsigned long ms)    { global_host_ticks += TICKS_FROM_MS(ms); }
+void timer_init(void)             {}
+reset_type_t sys_reset_type(void) { return RESET_WARM; }
+void register_VI_handler(void (*callback)(void)) { (void)callback; }
+void debug_init_isviewer(void)    {}
+void debug_init_usblog(void)      {}
+
+void sys_get_heap_stats(heap_stats_t* stats)
+{
+    // The host heap stands in for the console's, so leaks still show up
+    stats->total = 8*1024*1024;
+    stats->used = mallinfo2().uordblks;
+}
+
+void* malloc_uncached(size_t size)                  { return malloc(size); }
+void* malloc_uncached_aligned(int align, size_t size) { return aligned_alloc(align, (size + align - 1) & ~(size_t)(align - 1)); }
+void  free_uncached(void* buf)                      { free(buf); }
+void  data_cache_hit_writeback(const void* addr, unsigned long length)            { (void)addr; (void)length; }
+void  data_cache_hit_writeback_invalidate(const void* addr, unsigned long length) { (void)addr; (void)length; }
+
+void debugf(const char* fmt, ...)
+{
+    va_list args;
+    if (!global_host_verbose)
+        return;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+}
+
+
+/*********************************
+        Filesystem/Assets
+*********************************/
+
+int dfs_init(uint32_t base_fs_loc)  { (void)base_fs_loc; return 0; }
+void asset_init_compression(int algo) { (void)algo; }
+
+static int host_dir_read(dir_t* dir)
+{
+    struct dirent* ent;
+    while ((ent = readdir((DIR*)dir->d_cookie)) != NULL)
+    {
+        if (ent->d_name[0] == '.')
+            continue;
+        snprintf(dir->d_name, sizeof(dir->d_name), "%s", ent->d_name);
+        dir->d_type = (ent->d_type == DT_DIR) ? 2 : 1;
+        dir->d_size = 0;
+        return 0;
+    }
+    closedir((DIR*)dir->d_cookie);
+    dir->d_cookie = NULL;
+    return -1;
+}
+
+int dir_findfirst(const char* path, dir_t* dir)
+{
+    char fullpath[1024];
+    host_romfile(fullpath, sizeof(fullpath), path);
+    dir->d_cookie = opendir(fullpath);
+    assertf(dir->d_cookie != NULL, "Unable to open host directory %s", fullpath);
+    return host_dir_read(dir);
+}
+
+int dir_findnext(const char* path, dir_t* dir)
+{
+    (void)path;
+    if (dir->d_cookie == NULL)
+        return -1;
+    return host_dir_read(dir);
+}
+
+FILE* asset_fopen(const char* fn, int* sz)
+{
+    char fullpath[1024];
+    FILE* f;
+    host_romfile(fullpath, sizeof(fullpath), fn);
+    f = fopen(fullpath, "rb");
+    assertf(f != NULL, "Unable to open asset %s", fullpath);
+    if (sz)
+    {
+        fseek(f, 0, SEEK_END);
+        *sz = (int)ftell(f);
+        fseek(f, 0, SEEK_SET);
+    }
+    return f;
+}
+
+void* asset_load(const char* fn, int* sz)
+{
+    int size;
+    void* buf;
+    FILE* f = asset_fopen(fn, &size);
+    buf = malloc(size + 1);
+    if (fread(buf, 1, size, f) != (size_t)size)
+        assertf(0, "Short read on asset %s", fn);
+    ((char*)buf)[size] = '\0';
+    fclose(f);
+    if (sz)
+        *sz = size;
+    return buf;
+}
+
+#undef dlopen
+void* host_dlopen(const char* filename, int mode)
+{
+    char fullpath[1024];
+    void* handle;
+    host_romfile(fullpath, sizeof(fullpath), filename);
+    handle = dlopen(fullpath, mode | RTLD_NOW);
+    assertf(handle != NULL, "dlopen failed: %s", dlerror());
+    return handle;
+}
+
+
+/*********************************
+            Graphics
+*********************************/
+
+void display_init(resolution_t res, bitdepth_t bit, uint32_t num_buffers, gamma_t gamma, filter_options_t filters)
+{
+    (void)bit; (void)num_buffers; (void)gamma; (void)filters;
+    global_host_surface.width = res.width;
+    global_host_surface.height = res.height;
+    global_host_surface.stride = res.width*2;
+}
+
+void       display_close(void)                  {}
+surface_t* display_get(void)                    { return &global_host_surface; }
+surface_t* display_try_get(void)                { return &global_host_surface; }
+surface_t* display_get_zbuf(void)               { return &global_host_surface; }
+void       display_show(surface_t* surf)        { (void)surf; }
+uint32_t   display_get_width(void)              { return global_host_surface.width; }
+uint32_t   display_get_height(void)             { return global_host_surface.height; }
+float      display_get_fps(void)                { return 1.0f/global_host_deltatime; }
+float      display_get_delta_time(void)         { return global_host_deltatime; }
+void       display_set_fps_limit(float fps)     { (void)fps; }
+
+sprite_t* sprite_load(const char* fn)
+{
+    (void)fn;
+    sprite_t* spr = (sprite_t*)calloc(1, sizeof(sprite_t));
+    spr->width = 32;
+    spr->height = 32;
+    spr->hslices = 1;
+    spr->vslices = 1;
+    return spr;
+}
+
+void      sprite_free(sprite_t* sprite)       { free(sprite); }
+surface_t sprite_get_pixels(sprite_t* sprite) { return (surface_t){.width = sprite->width, .height = sprite->height}; }
+
+
+/*********************************
+              RSPQ
+*********************************/
+
+void rspq_init(void)  {}
+void rspq_flush(void) {}
+void rspq_wait(void)  {}
+void rspq_block_begin(void) {}
+rspq_block_t* rspq_block_end(void) { return (rspq_block_t*)calloc(1, sizeof(rspq_block_t)); }
+void rspq_block_run(rspq_block_t* block)  { (void)block; }
+void rspq_block_free(rspq_block_t* block) { free(block); }
+rspq_syncpoint_t rspq_syncpoint_new(void) { return ++global_host_syncpoint; }
+bool rspq_syncpoint_check(rspq_syncpoint_t sync_id) { (void)sync_id; return true; }
+void rspq_syncpoint_wait(rspq_syncpoint_t sync_id)  { (void)sync_id; }
+
+
+/*********************************
+              RDPQ
+*********************************/
+
+void rdpq_init(void)  {}
+void rdpq_close(void) {}
+void rdpq_attach(const surface_t* surf_color, const surface_t* surf_z)       { (void)surf_color; (void)surf_z; }
+void rdpq_attach_clear(const surface_t* surf_color, const surface_t* surf_z) { (void)surf_color; (void)surf_z; }
+void rdpq_detach(void)      {}
+void rdpq_detach_wait(void) {}
+void rdpq_detach_show(void) {}
+void rdpq_clear(color_t color) { (void)color; }
+void rdpq_clear_z(uint16_t z)  { (void)z; }
+void rdpq_sync_pipe(void) {}
+void rdpq_sync_tile(void) {}
+void rdpq_sync_load(void) {}
+void rdpq_sync_full(void (*callback)(void*), void* arg) { (void)callback; (void)arg; }
+void rdpq_set_mode_standard(void) {}
+void rdpq_set_mode_copy(bool transparency) { (void)transparency; }
+void rdpq_set_mode_fill(color_t color)     { (void)color; }
+void rdpq_mode_begin(void) {}
+void rdpq_mode_end(void)   {}
+void rdpq_mode_push(void)  {}
+void rdpq_mode_pop(void)   {}
+void rdpq_mode_combiner(rdpq_combiner_t comb)   { (void)comb; }
+void rdpq_mode_blender(rdpq_blender_t blend)    { (void)blend; }
+void rdpq_mode_alphacompare(int threshold)      { (void)threshold; }
+void rdpq_mode_filter(rdpq_filter_t filt)       { (void)filt; }
+void rdpq_mode_dithering(rdpq_dither_t dither)  { (void)dither; }
+void rdpq_mode_zbuf(bool compare, bool update)  { (void)compare; (void)update; }
+void rdpq_mode_antialias(int mode)              { (void)mode; }
+void rdpq_mode_persp(bool perspective)          { (void)perspective; }
+void rdpq_set_prim_color(color_t color)  { (void)color; }
+void rdpq_set_env_color(color_t color)   { (void)color; }
+void rdpq_set_blend_color(color_t color) { (void)color; }
+void rdpq_set_fog_color(color_t color)   { (void)color; }
+void rdpq_set_fill_color(color_t color)  { (void)color; }
+void rdpq_set_scissor(int x0, int y0, int x1, int y1) { (void)x0; (void)y0; (void)x1; (void)y1; }
+void rdpq_fill_rectangle(float x0, float y0, float x1, float y1) { (void)x0; (void)y0; (void)x1; (void)y1; }
+void rdpq_texture_rectangle(rdpq_tile_t tile, float x0, float y0, float x1, float y1, float s, float t)
+{
+    (void)tile; (void)x0; (void)y0; (void)x1; (void)y1; (void)s; (void)t;
+}
+void rdpq_texture_rectangle_scaled(rdpq_tile_t tile, float x0, float y0, float x1, float y1, float s0, float t0, float s1, float t1)
+{
+    (void)tile; (void)x0; (void)y0; (void)x1; (void)y1; (void)s0; (void)t0; (void)s1; (void)t1;
+}
+void rdpq_tex_multi_begin(void) {}
+int  rdpq_tex_multi_end(void)   { return 0; }
+int  rdpq_sprite_upload(rdpq_tile_t tile, sprite_t* sprite, const rdpq_texparms_t* parms)  { (void)tile; (void)sprite; (void)parms; return 0; }
+int  rdpq_tex_upload(rdpq_tile_t tile, const surface_t* tex, const rdpq_texparms_t* parms) { (void)tile; (void)tex; (void)parms; return 0; }
+void rdpq_tex_reuse_sub(rdpq_tile_t tile, const rdpq_texparms_t* parms, int s0, int t0, int s1, int t1)
+{
+    (void)tile; (void)parms; (void)s0; (void)t0; (void)s1; (void)t1;
+}
+void rdpq_sprite_blit(sprite_t* sprite, float x0, float y0, const rdpq_blitparms_t* parms) { (void)sprite; (void)x0; (void)y0; (void)parms; }
+void rdpq_tex_blit(const surface_t* surf, float x0, float y0, const rdpq_blitparms_t* parms) { (void)surf; (void)x0; (void)y0; (void)parms; }
+void rdpq_debug_start(void)    {}
+void rdpq_debug_log(bool log)  { (void)log; }
+
+
+/*********************************
+            RDPQ Text
+*********************************/
+
+rdpq_font_t* rdpq_font_load(const char* fn)                      { (void)fn; return (rdpq_font_t*)calloc(1, sizeof(rdpq_font_t)); }
+rdpq_font_t* rdpq_font_load_builtin(rdpq_font_builtin_t font)    { (void)font; return (rdpq_font_t*)calloc(1, sizeof(rdpq_font_t)); }
+void rdpq_font_free(rdpq_font_t* fnt)                            { free(fnt); }
+void rdpq_text_register_font(uint8_t font_id, const rdpq_font_t* font) { (void)font_id; (void)font; }
+void rdpq_text_unregister_font(uint8_t font_id)                  { (void)font_id; }
+
+void rdpq_font_style(rdpq_font_t* font, uint8_t style_id, const rdpq_fontstyle_t* style)
+{
+    font->styles[style_id % 16] = *style;
+}
+
+rdpq_textmetrics_t rdpq_text_print(const rdpq_textparms_t* parms, uint8_t font_id, float x0, float y0, const char* utf8_text)
+{
+    return rdpq_text_printn(parms, font_id, x0, y0, utf8_text, strlen(utf8_text));
+}
+
+rdpq_textmetrics_t rdpq_text_printn(const rdpq_textparms_t* parms, uint8_t font_id, float x0, float y0, const char* utf8_text, int nbytes)
+{
+    int lines = 1;
+    (void)parms; (void)font_id; (void)x0; (void)y0;
+    for (int i=0; i<nbytes; i++)
+        if (utf8_text[i] == '\n')
+            lines++;
+    return (rdpq_textmetrics_t){.advance_x = 0, .advance_y = 12.0f*lines, .utf8_text_advance = nbytes, .nlines = lines};
+}
+
+rdpq_textmetrics_t rdpq_text_printf(const rdpq_textparms_t* parms, uint8_t font_id, float x0, float y0, const char* utf8_fmt, ...)
+{
+    char buf[512];
+    va_list args;
+    va_start(args, utf8_fmt);
+    vsnprintf(buf, sizeof(buf), utf8_fmt, args);
+    va_end(args);
+    return rdpq_text_print(parms, font_id, x0, y0, buf);
+}
+
+
+/*********************************
+             Joypad
+*********************************/
+
+void joypad_init(void)  {}
+void joypad_close(void) {}
+
+void joypad_poll(void)
+{
+    for (int i=0; i<JOYPAD_PORT_COUNT; i++)
+    {
+        global_host_joypad_prev[i] = global_host_joypad_cur[i];
+        global_host_joypad_cur[i] = global_host_joypad_next[i];
+    }
+}
+
+bool             joypad_is_connected(joypad_port_t port) { (void)port; return true; }
+joypad_style_t   joypad_get_style(joypad_port_t port)    { (void)port; return JOYPAD_STYLE_N64; }
+joypad_inputs_t  joypad_get_inputs(joypad_port_t port)   { return global_host_joypad_cur[port]; }
+joypad_buttons_t joypad_get_buttons(joypad_port_t port)  { return global_host_joypad_cur[port].btn; }
+
+joypad_buttons_t joypad_get_buttons_pressed(joypad_port_t port)
+{
+    uint16_t cur = global_host_joypad_cur[port].btn.raw, prev = global_host_joypad_prev[port].btn.raw;
+    return (joypad_buttons_t){.raw = (uint16_t)(cur & ~prev)};
+}
+
+joypad_buttons_t joypad_get_buttons_released(joypad_port_t port)
+{
+    uint16_t cur = global_host_joypad_cur[port].btn.raw, prev = global_host_joypad_prev[port].btn.raw;
+    return (joypad_buttons_t){.raw = (uint16_t)(~cur & prev)};
+}
+
+joypad_buttons_t joypad_get_buttons_held(joypad_port_t port)
+{
+    uint16_t cur = global_host_joypad_cur[port].btn.raw, prev = global_host_joypad_prev[port].btn.raw;
+    return (joypad_buttons_t){.raw = (uint16_t)(cur & prev)};
+}
+
+static int host_axis_value(const joypad_inputs_t* in, joypad_axis_t axis)
+{
+    switch (axis)
+    {
+        case JOYPAD_AXIS_STICK_X:  return in->stick_x;
+        case JOYPAD_AXIS_STICK_Y:  return in->stick_y;
+        case JOYPAD_AXIS_CSTICK_X: return in->cstick_x;
+        case JOYPAD_AXIS_CSTICK_Y: return in->cstick_y;
+        case JOYPAD_AXIS_ANALOG_L: return in->analog_l;
+        case JOYPAD_AXIS_ANALOG_R: return in->analog_r;
+    }
+    return 0;
+}
+
+static int host_axis_direction(int value)
+{
+    // Same dead zone libdragon uses to turn an axis into a digital direction
+    if (value > 32)
+        return 1;
+    if (value < -32)
+        return -1;
+    return 0;
+}
+
+int joypad_get_axis_pressed(joypad_port_t port, joypad_axis_t axis)
+{
+    int cur = host_axis_direction(host_axis_value(&global_host_joypad_cur[port], axis));
+    int prev = host_axis_direction(host_axis_value(&global_host_joypad_prev[port], axis));
+    return (cur != prev) ? cur : 0;
+}
+
+int joypad_get_axis_released(joypad_port_t port, joypad_axis_t axis)
+{
+    int cur = host_axis_direction(host_axis_value(&global_host_joypad_cur[port], axis));
+    int prev = host_axis_direction(host_axis_value(&global_host_joypad_prev[port], axis));
+    return (cur != prev) ? prev : 0;
+}
+
+int joypad_get_axis_held(joypad_port_t port, joypad_axis_t axis)
+{
+    int cur = host_axis_direction(host_axis_value(&global_host_joypad_cur[port], axis));
+    int prev = host_axis_direction(host_axis_value(&global_host_joypad_prev[port], axis));
+    return (cur == prev) ? cur : 0;
+}
+
+joypad_8way_t joypad_get_direction(joypad_port_t port, joypad_2d_t axes)
+{
+    const joypad_inputs_t* in = &global_host_joypad_cur[port];
+    int x = 0, y = 0;
+    static const joypad_8way_t table[3][3] = {
+        {JOYPAD_8WAY_DOWN_LEFT, JOYPAD_8WAY_LEFT, JOYPAD_8WAY_UP_LEFT},
+        {JOYPAD_8WAY_DOWN,      JOYPAD_8WAY_NONE, JOYPAD_8WAY_UP},
+        {JOYPAD_8WAY_DOWN_RIGHT, JOYPAD_8WAY_RIGHT, JOYPAD_8WAY_UP_RIGHT},
+    };
+    if (axes == JOYPAD_2D_DPAD || axes == JOYPAD_2D_LH || axes == JOYPAD_2D_ANY)
+    {
+        x += in->btn.d_right - in->btn.d_left;
+        y += in->btn.d_up - in->btn.d_down;
+    }
+    if (axes == JOYPAD_2D_STICK || axes == JOYPAD_2D_LH || axes == JOYPAD_2D_LR || axes == JOYPAD_2D_ANY)
+    {
+        x += host_axis_direction(in->stick_x);
+        y += host_axis_direction(in->stick_y);
+    }
+    if (axes == JOYPAD_2D_CSTICK || axes == JOYPAD_2D_RH || axes == JOYPAD_2D_LR || axes == JOYPAD_2D_ANY)
+    {
+        x += in->btn.c_right - in->btn.c_left;
+        y += in->btn.c_up - in->btn.c_down;
+    }
+    x = (x > 0) - (x < 0);
+    y = (y > 0) - (y < 0);
+    return table[x+1][y+1];
+}
+
+void joypad_set_rumble_active(joypad_port_t port, bool active) { (void)port; (void)active; }
+bool joypad_get_rumble_supported(joypad_port_t port)          { (void)port; return false; }
+
+
+/*********************************
+              Audio
+*********************************/
+
+void audio_init(int frequency, int numbuffers) { (void)frequency; (void)numbuffers; }
+void audio_close(void)            {}
+void mixer_init(int num_channels) { (void)num_channels; }
+void mixer_close(void)            {}
+
+void mixer_try_play(void)
+{
+    // Non-looping music ends on its own, some games wait for that
+    for (int i=0; i<HOST_MAX_XM64PLAYERS; i++)
+    {
+        xm64player_t* player = global_host_xm64players[i];
+        if (player != NULL && player->playing && !player->looping && (get_ticks() - player->start_ticks) >= HOST_XM64_DURATION*TICKS_PER_SECOND)
+            player->playing = false;
+    }
+}
+
+void mixer_set_vol(float vol)     { (void)vol; }
+void mixer_ch_set_vol(int ch, float lvol, float rvol) { (void)ch; (void)lvol; (void)rvol; }
+void mixer_ch_set_freq(int ch, float frequency)      { (void)ch; (void)frequency; }
+void mixer_ch_set_limits(int ch, int max_bits, float max_frequency, int max_buf_sz) { (void)ch; (void)max_bits; (void)max_frequency; (void)max_buf_sz; }
+void mixer_ch_stop(int ch)        { (void)ch; }
+bool mixer_ch_playing(int ch)     { (void)ch; return false; }
+
+void wav64_open(wav64_t* wav, const char* fn)   { memset(wav, 0, sizeof(wav64_t)); wav->wave.name = fn; }
+wav64_t* wav64_load(const char* fn, void* parms) { (void)parms; wav64_t* wav = (wav64_t*)malloc(sizeof(wav64_t)); wav64_open(wav, fn); return wav; }
+void wav64_play(wav64_t* wav, int ch)           { (void)wav; (void)ch; }
+void wav64_set_loop(wav64_t* wav, bool loop)    { (void)wav; (void)loop; }
+void wav64_close(wav64_t* wav)                  { (void)wav; }
+
+void xm64player_open(xm64player_t* player, const char* fn)
+{
+    (void)fn;
+    memset(player, 0, sizeof(xm64player_t));
+    player->volume = 1.0f;
+    player->looping = true;
+    for (int i=0; i<HOST_MAX_XM64PLAYERS; i++)
+    {
+        if (global_host_xm64players[i] == NULL)
+        {
+            global_host_xm64players[i] = player;
+            break;
+        }
+    }
+}
+
+void xm64player_close(xm64player_t* player)
+{
+    player->playing = false;
+    for (int i=0; i<HOST_MAX_XM64PLAYERS; i++)
+        if (global_host_xm64players[i] == player)
+            global_host_xm64players[i] = NULL;
+}
+
+void xm64player_play(xm64player_t* player, int first_ch)     { player->first_ch = first_ch; player->playing = true; player->start_ticks = get_ticks(); }
+void xm64player_stop(xm64player_t* player)                   { player->playing = false; }
+void xm64player_set_loop(xm64player_t* player, bool loop)    { player->looping = loop; }
+void xm64player_set_vol(xm64player_t* player, float volume)  { player->volume = volume; }
+void xm64player_seek(xm64player_t* player, int patidx, int row, int tick) { (void)player; (void)patidx; (void)row; (void)tick; }
+int  xm64player_num_channels(xm64player_t* player)           { (void)player; return 8; }
@@ -0,0 +1,125 @@
+/***************************************************************
+                           host/main.c
+
+The host runner entrypoint. Loads the minigame DSOs built for
+Linux, enters LEVEL_MINIGAME through the real core level system
+and steps it with the same fixed timestep as the ROM, but as
+fast as the host can go.
+
+Usage: minigame_host [options] <internalname>
+  -t <ticks>   Maximum number of fixed ticks to run (default 9000)
+  -s <seed>    Seed passed to srand (default 1)
+  -a <diff>    AI difficulty, 0 to 2 (default 1)
+  -r <dir>     Host directory that stands in for rom:/
+  -f           Only step the fixed loop, skip the draw loop
+  -v           Print debugf output
+  -l           List the available minigames and exit
+  -R <file>    Record the inputs to a replay file
+  -P <file>    Play back the inputs (and seed) from a replay file
+***************************************************************/
+
+#include <libdragon.h>
+#include "core.h"
+#include "config.h"
+#include "minigame.h"
+#include "runner.h"
+
+
+/*********************************
+           Definitions
+*********************************/
+
+#define DEFAULT_MAXTICKS  (TICKRATE*60*5)
+
+
+/*==============================
+    usage
+    Prints the program usage and exits
+    @param  The program name
+==============================*/
+
+static void usage(const char* prog)
+{
+    fprintf(stderr, "Usage: %s [-t ticks] [-s seed] [-a difficulty] [-r romdir] [-f] [-v] [-l] [-R replay] [-P replay] <internalname>\n", prog);
+    exit(1);
+}
+
+
+/*==============================
+    main
+    The program main
+==============================*/
+
+int main(int argc, char** argv)
+{
+    const float dt = DELTATIME;
+    HostRun run;
+    uint32_t maxticks = DEFAULT_MAXTICKS;
+    uint32_t seed = 1;
+    AiDiff difficulty = AI_DIFFICULTY;
+    bool fixedonly = false;
+    bool listonly = false;
+    bool noplayers[MAXPLAYERS] = {false, false, false, false};
+    const char* name;
+    const char* recordpath = NULL;
+    const char* playpath = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:s:a:r:fvlR:P:")) != -1)
+    {
+        switch (opt)
+        {
+            case 't': maxticks = strtoul(optarg, NULL, 10); break;
+            case 's': seed = strtoul(optarg, NULL, 10); break;
+            case 'a': difficulty = (AiDiff)atoi(optarg); break;
+            case 'r': host_set_romdir(optarg); break;
+            case 'f': fixedonly = true; break;
+            case 'v': host_set_verbose(true); break;
+            case 'l': listonly = true; break;
+            case 'R': recordpath = optarg; break;
+            case 'P': playpath = optarg; break;
+            default: usage(argv[0]);
+        }
+    }
+
+    // Register every minigame the same way the ROM does
+    minigame_loadall();
+    if (listonly)
+    {
+        for (size_t i=0; i<global_minigame_count; i++)
+            printf("%s\t%s\n", global_minigame_list[i].internalname, global_minigame_list[i].definition.gamename);
+        return 0;
+    }
+    if (optind >= argc)
+        usage(argv[0]);
+    name = argv[optind];
+
+    // Every player is an AI
+    if (recordpath != NULL)
+        replay_start_recording(recordpath, seed);
+    else if (playpath != NULL && !replay_start_playback(playpath, &seed))
+        return 1;
+    srand(seed);
+    core_initlevels();
+    core_set_playercount(noplayers);
+    core_set_aidifficulty(difficulty);
+    core_set_nextround(NR_FREEPLAY);
+
+    host_run_minigame(name, maxticks, fixedonly, &run);
+
+    // Report
+    printf("minigame:   %s\n", name);
+    printf("ticks:      %u (%s, %.1f simulated seconds)\n", run.ticks, run.ended ? "ended" : "tick limit", run.ticks*dt);
+    printf("init:       %.3f ms\n", run.time_init/1e6);
+    printf("fixedloop:  %.3f us/tick\n", run.ticks ? (run.time_fixed/1e3)/run.ticks : 0.0);
+    if (!fixedonly)
+        printf("loop:       %.3f us/tick\n", run.ticks ? (run.time_loop/1e3)/run.ticks : 0.0);
+    printf("cleanup:    %.3f ms\n", run.time_cleanup/1e6);
+    printf("realtime:   %.0fx\n", (run.time_fixed + run.time_loop) ? (run.ticks*dt*1e9)/(double)(run.time_fixed + run.time_loop) : 0.0);
+    printf("winners:   ");
+    for (int i=0; i<MAXPLAYERS; i++)
+        if (run.winners[i])
+            printf(" P%d", i+1);
+    printf("\n");
+    return 0;
+}
@@ -0,0 +1,86 @@
+/***************************************************************
+                            runner.c
+
+Plays a single minigame through the real core level system, with
+the same fixed timestep as the ROM but as fast as the host can
+go. Shared by the minigame runner and the tournament simulator.
+***************************************************************/
+
+#include <libdragon.h>
+#include <time.h>
+#include "core.h"
+#include "minigame.h"
+#include "replay.h"
+#include "runner.h"
+
+
+/*==============================
+    host_time_ns
+    Gets the host's monotonic clock
+    @return The current time, in nanoseconds
+==============================*/
+
+uint64_t host_time_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec*1000000000ull + ts.tv_nsec;
+}
+
+
+/*==============================
+    host_run_minigame
+    Plays a minigame until it ends or runs out of ticks. The
+    player count, AI difficulty and next round type must have
+    been set beforehand
+    @param  The internal name of the minigame
+    @param  The maximum number of fixed ticks to run
+    @param  Whether to skip the draw loop
+    @param  Where to store the outcome
+==============================*/
+
+void host_run_minigame(const char* name, uint32_t maxticks, bool fixedonly, HostRun* out)
+{
+    const float dt = DELTATIME;
+    uint64_t start;
+    memset(out, 0, sizeof(HostRun));
+
+    // Initialize the minigame
+    minigame_loadnext((char*)name);
+    core_level_changeto(LEVEL_MINIGAME);
+    start = host_time_ns();
+    core_level_doinit();
+    out->time_init = host_time_ns() - start;
+
+    // Same loop as main.c, minus the accumulator, since host time doesn't matter
+    while (!core_level_waschanged() && out->ticks < maxticks)
+    {
+        host_advance_time(dt);
+
+        start = host_time_ns();
+        core_level_dofixedloop(dt);
+        out->time_fixed += host_time_ns() - start;
+        out->ticks++;
+
+        replay_frametime(dt);
+        replay_poll();
+        mixer_try_play();
+        if (!fixedonly)
+        {
+            start = host_time_ns();
+            core_set_subtick(0);
+            core_level_doloop(dt);
+            out->time_loop += host_time_ns() - start;
+        }
+        core_level_endframe();
+    }
+    out->ended = core_level_waschanged();
+
+    // End the minigame
+    start = host_time_ns();
+    core_level_docleanup();
+    replay_save();
+    out->time_cleanup = host_time_ns() - start;
+    for (int i=0; i<MAXPLAYERS; i++)
+        out->winners[i] = core_get_winner(i);
+}
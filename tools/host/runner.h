@@ -0,0 +1,21 @@
+#ifndef GAMEJAM2024_HOST_RUNNER_H
+#define GAMEJAM2024_HOST_RUNNER_H
+
+    #include <libdragon.h>
+    #include "core.h"
+
+    // The outcome of a single minigame, times are in host nanoseconds
+    typedef struct {
+        uint32_t ticks;
+        bool     ended;
+        bool     winners[MAXPLAYERS];
+        uint64_t time_init;
+        uint64_t time_fixed;
+        uint64_t time_loop;
+        uint64_t time_cleanup;
+    } HostRun;
+
+    extern uint64_t host_time_ns();
+    extern void     host_run_minigame(const char* name, uint32_t maxticks, bool fixedonly, HostRun* out);
+
+#endif
@@ -0,0 +1,195 @@
+/***************************************************************
+                           t3d_stub.c
+
+Host implementation of the Tiny3D subset declared in
+include/t3d. Nothing is drawn, but animation playback time and
+the camera are tracked so game logic depending on them runs.
+***************************************************************/
+
+#include <libdragon.h>
+#include <t3d/t3d.h>
+#include <t3d/t3dmath.h>
+#include <t3d/t3dmodel.h>
+#include <t3d/t3dskeleton.h>
+#include <t3d/t3danim.h>
+#include <t3d/t3ddebug.h>
+
+
+/*********************************
+              Core
+*********************************/
+
+void t3d_init(T3DInitParams params)  { (void)params; }
+void t3d_destroy(void)               {}
+void t3d_frame_start(void)           {}
+void t3d_screen_clear_color(color_t color) { (void)color; }
+void t3d_screen_clear_depth(void)    {}
+void t3d_state_set_drawflags(int drawFlags) { (void)drawFlags; }
+void t3d_light_set_ambient(const uint8_t* color) { (void)color; }
+void t3d_light_set_directional(int index, const uint8_t* color, const T3DVec3* dir) { (void)index; (void)color; (void)dir; }
+void t3d_light_set_point(int index, const uint8_t* color, const T3DVec3* pos, float size, bool ignoreNormals) { (void)index; (void)color; (void)pos; (void)size; (void)ignoreNormals; }
+void t3d_light_set_count(int count)  { (void)count; }
+void t3d_fog_set_enabled(bool isEnabled) { (void)isEnabled; }
+void t3d_fog_set_range(float near, float far) { (void)near; (void)far; }
+void t3d_matrix_push(const T3DMat4FP* mat) { (void)mat; }
+void t3d_matrix_pop(int count)       { (void)count; }
+void t3d_matrix_set(const T3DMat4FP* mat, bool doMultiply) { (void)mat; (void)doMultiply; }
+void t3d_matrix_push_pos(int count)  { (void)count; }
+
+
+/*********************************
+            Viewport
+*********************************/
+
+T3DViewport t3d_viewport_create(void)
+{
+    T3DViewport vp;
+    memset(&vp, 0, sizeof(T3DViewport));
+    t3d_mat4_identity(&vp.matCamera);
+    t3d_mat4_identity(&vp.matProj);
+    vp.size[0] = display_get_width();
+    vp.size[1] = display_get_height();
+    return vp;
+}
+
+void t3d_viewport_attach(T3DViewport* viewport) { (void)viewport; }
+
+void t3d_viewport_set_area(T3DViewport* viewport, int x, int y, int width, int height)
+{
+    viewport->offset[0] = x;
+    viewport->offset[1] = y;
+    viewport->size[0] = width;
+    viewport->size[1] = height;
+}
+
+void t3d_viewport_set_projection(T3DViewport* viewport, float fov, float near, float far)
+{
+    viewport->fov = fov;
+    viewport->near = near;
+    viewport->far = far;
+}
+
+void t3d_viewport_look_at(T3DViewport* viewport, const T3DVec3* eye, const T3DVec3* target, const T3DVec3* up)
+{
+    (void)up;
+    viewport->camPos = *eye;
+    viewport->camTarget = *target;
+}
+
+void t3d_viewport_calc_viewspace_pos(T3DViewport* viewport, T3DVec3* out, const T3DVec3* pos)
+{
+    // No projection is available, so report positions relative to the screen center
+    out->v[0] = viewport->offset[0] + viewport->size[0]/2 + (pos->v[0] - viewport->camTarget.v[0]);
+    out->v[1] = viewport->offset[1] + viewport->size[1]/2 + (pos->v[2] - viewport->camTarget.v[2]);
+    out->v[2] = 0.5f;
+}
+
+
+/*********************************
+             Models
+*********************************/
+
+T3DModel* t3d_model_load(const char* path)
+{
+    T3DModel* model = (T3DModel*)calloc(1, sizeof(T3DModel));
+    model->path = strdup(path);
+    return model;
+}
+
+void t3d_model_free(T3DModel* model)
+{
+    free(model->path);
+    free(model);
+}
+
+void t3d_model_draw(const T3DModel* model) { (void)model; }
+void t3d_model_draw_skinned(const T3DModel* model, const T3DSkeleton* skeleton) { (void)model; (void)skeleton; }
+T3DObject* t3d_model_get_object(const T3DModel* model, const char* name) { (void)model; (void)name; return NULL; }
+void t3d_model_draw_object(const T3DObject* object, const T3DMat4FP* boneMatrices) { (void)object; (void)boneMatrices; }
+
+
+/*********************************
+            Skeletons
+*********************************/
+
+T3DSkeleton t3d_skeleton_create(const T3DModel* model)
+{
+    return (T3DSkeleton){.skeletonRef = model, .boneMatricesFP = NULL, .boneCount = 0};
+}
+
+T3DSkeleton t3d_skeleton_create_buffered(const T3DModel* model, int bufferCount)
+{
+    (void)bufferCount;
+    return t3d_skeleton_create(model);
+}
+
+T3DSkeleton t3d_skeleton_clone(const T3DSkeleton* skel, bool useMatrices)
+{
+    (void)useMatrices;
+    return *skel;
+}
+
+void t3d_skeleton_update(T3DSkeleton* skel) { (void)skel; }
+void t3d_skeleton_blend(const T3DSkeleton* skelRes, const T3DSkeleton* skelA, const T3DSkeleton* skelB, float factor) { (void)skelRes; (void)skelA; (void)skelB; (void)factor; }
+void t3d_skeleton_reset(T3DSkeleton* skel)   { (void)skel; }
+void t3d_skeleton_destroy(T3DSkeleton* skel) { (void)skel; }
+int  t3d_skeleton_find_bone(T3DSkeleton* skel, const char* name) { (void)skel; (void)name; return -1; }
+
+
+/*********************************
+           Animations
+*********************************/
+
+T3DAnim t3d_anim_create(const T3DModel* model, const char* name)
+{
+    (void)name;
+    return (T3DAnim){
+        .animRef = model,
+        .time = 0.0f,
+        .speed = 1.0f,
+        .duration = HOST_T3D_ANIM_DURATION,
+        .isPlaying = true,
+        .isLooping = true,
+    };
+}
+
+void t3d_anim_attach(T3DAnim* anim, const T3DSkeleton* skeleton)
+{
+    anim->skel = (T3DSkeleton*)skeleton;
+}
+
+void t3d_anim_set_time(T3DAnim* anim, float time)
+{
+    anim->time = time;
+}
+
+void t3d_anim_update(T3DAnim* anim, float deltaTime)
+{
+    if (!anim->isPlaying)
+        return;
+    anim->time += deltaTime * anim->speed;
+    if (anim->time >= anim->duration)
+    {
+        if (anim->isLooping)
+        {
+            anim->time = fmodf(anim->time, anim->duration);
+        }
+        else
+        {
+            anim->time = anim->duration;
+            anim->isPlaying = false;
+        }
+    }
+}
+
+void t3d_anim_destroy(T3DAnim* anim) { (void)anim; }
+
+
+/*********************************
+              Debug
+*********************************/
+
+void t3d_debug_print_init(void)  {}
+void t3d_debug_print_start(void) {}
+void t3d_debug_print(float x, float y, const char* str) { (void)x; (void)y; (void)str; }
+void t3d_debug_printf(float x, float y, const char* fmt, ...) { (void)x; (void)y; (void)fmt; }
@@ -0,0 +1,509 @@
+/***************************************************************
+                        host/tournament.c
+
+Plays whole sessions with four AI players on the host, the way
+the ROM would after game setup: the next round type picks who
+chooses, the chooser picks a random minigame, winners earn a
+point, and the session ends once someone reaches the points to
+win. Sessions are spread over a pool of worker processes, since
+the core and the minigame DSOs keep their state in globals.
+
+Session i uses the AI difficulty i%3, the next round type
+(i/3)%4 and the seed base+i, so the results of a session do not
+depend on how many workers ran it.
+
+Usage: tournament_host [options]
+  -n <count>   Number of sessions to play (default 300)
+  -j <jobs>    Number of worker processes (default: one per CPU)
+  -p <points>  Points needed to win a session, 1 to 7 (default 4)
+  -s <seed>    Seed of the first session (default 1)
+  -t <ticks>   Maximum number of fixed ticks per minigame (default 9000)
+  -c <rounds>  Maximum number of rounds per session (default 100)
+  -a <diff>    Only play sessions with this AI difficulty
+  -m <mode>    Only play sessions with this next round type
+  -r <dir>     Host directory that stands in for rom:/
+  -f           Only step the fixed loop, skip the draw loop
+***************************************************************/
+
+#include <libdragon.h>
+#include <sys/wait.h>
+#include <errno.h>
+#include "core.h"
+#include "minigame.h"
+#include "runner.h"
+
+
+/*********************************
+           Definitions
+*********************************/
+
+#define DEFAULT_SESSIONS   300
+#define DEFAULT_POINTS     4
+#define DEFAULT_MAXTICKS   (TICKRATE*60*5)
+#define DEFAULT_MAXROUNDS  100
+
+#define MAXGAMES   64
+#define DIFFCOUNT  3
+#define MODECOUNT  4
+
+
+/*********************************
+            Structures
+*********************************/
+
+typedef struct {
+    uint32_t plays;
+    uint32_t timeouts;
+    uint32_t nowinner;
+    uint64_t ticks;
+    uint64_t time_init;
+    uint64_t time_fixed;
+    uint64_t time_loop;
+    uint64_t time_cleanup;
+    uint32_t wins[DIFFCOUNT][MAXPLAYERS];
+    uint32_t playsperdiff[DIFFCOUNT];
+} GameStats;
+
+typedef struct {
+    uint32_t sessions;
+    uint32_t unfinished;
+    uint32_t rounds;
+    uint32_t minrounds;
+    uint32_t maxrounds;
+    uint64_t ticks;
+    uint32_t winners[MAXPLAYERS];
+} SessionStats;
+
+typedef struct {
+    GameStats    games[MAXGAMES];
+    SessionStats sessions[DIFFCOUNT][MODECOUNT];
+} TournamentStats;
+
+typedef struct {
+    uint32_t points;
+    uint32_t maxticks;
+    uint32_t maxrounds;
+    bool     fixedonly;
+} TournamentConfig;
+
+
+/*********************************
+             Globals
+*********************************/
+
+static const char* global_tournament_diffnames[DIFFCOUNT] = {"easy", "medium", "hard"};
+static const char* global_tournament_modenames[MODECOUNT] = {"least", "robin", "randomply", "randomgame"};
+
+
+/*==============================
+    usage
+    Prints the program usage and exits
+    @param  The program name
+==============================*/
+
+static void usage(const char* prog)
+{
+    fprintf(stderr, "Usage: %s [-n sessions] [-j jobs] [-p points] [-s seed] [-t ticks] [-c rounds] [-a difficulty] [-m mode] [-r romdir] [-f]\n", prog);
+    exit(1);
+}
+
+
+/*==============================
+    tournament_pickchooser
+    Picks who chooses the next minigame, the same way
+    results_init does
+    @param  The points of every player
+==============================*/
+
+static void tournament_pickchooser(const uint32_t* points)
+{
+    if (core_get_nextround() == NR_LEAST)
+    {
+        uint32_t smallest = UINT32_MAX;
+        int choicecount = 0;
+        int selected;
+        for (int i=0; i<MAXPLAYERS; i++)
+            if (points[i] < smallest)
+                smallest = points[i];
+        for (int i=0; i<MAXPLAYERS; i++)
+            if (points[i] == smallest)
+                choicecount++;
+        selected = rand() % choicecount;
+        for (int i=0; i<MAXPLAYERS; i++)
+        {
+            if (points[i] == smallest)
+            {
+                choicecount--;
+                if (choicecount == selected)
+                {
+                    core_set_curchooser(i);
+                    break;
+                }
+            }
+        }
+    }
+    else if (core_get_nextround() == NR_ROBIN)
+        core_set_curchooser((core_get_curchooser() + 1) % MAXPLAYERS);
+    else if (core_get_nextround() == NR_RANDOMPLY)
+        core_set_curchooser(rand() % MAXPLAYERS);
+}
+
+
+/*==============================
+    tournament_session
+    Plays a whole session and accumulates its results
+    @param  The session configuration
+    @param  The AI difficulty
+    @param  The next round type
+    @param  The seed of the session
+    @param  The stats to accumulate into
+==============================*/
+
+static void tournament_session(const TournamentConfig* cfg, AiDiff diff, NextRound mode, uint32_t seed, TournamentStats* stats)
+{
+    SessionStats* session = &stats->sessions[diff][mode];
+    bool noplayers[MAXPLAYERS] = {false, false, false, false};
+    uint32_t points[MAXPLAYERS] = {0, 0, 0, 0};
+    uint32_t rounds = 0;
+    uint64_t ticks = 0;
+    int winner = -1;
+
+    srand(seed);
+    core_set_playercount(noplayers);
+    core_set_aidifficulty(diff);
+    core_set_nextround(mode);
+    core_set_curchooser(PLAYER_1);
+
+    while (winner == -1 && rounds < cfg->maxrounds)
+    {
+        size_t index = rand() % global_minigame_count;
+        GameStats* game = &stats->games[index];
+        HostRun run;
+        bool anywinner = false;
+
+        host_run_minigame(global_minigame_list[index].internalname, cfg->maxticks, cfg->fixedonly, &run);
+        rounds++;
+        ticks += run.ticks;
+
+        // Accumulate the minigame stats
+        game->plays++;
+        game->playsperdiff[diff]++;
+        game->ticks += run.ticks;
+        game->time_init += run.time_init;
+        game->time_fixed += run.time_fixed;
+        game->time_loop += run.time_loop;
+        game->time_cleanup += run.time_cleanup;
+        if (!run.ended)
+            game->timeouts++;
+
+        // Award the points, ties go to the lowest player like on the results screen
+        for (int i=0; i<MAXPLAYERS; i++)
+        {
+            if (!run.winners[i])
+                continue;
+            anywinner = true;
+            game->wins[diff][i]++;
+            points[i]++;
+            if (points[i] >= cfg->points && winner == -1)
+                winner = i;
+        }
+        if (!anywinner)
+            game->nowinner++;
+        tournament_pickchooser(points);
+    }
+
+    // Accumulate the session stats
+    if (session->sessions == 0 || rounds < session->minrounds)
+        session->minrounds = rounds;
+    if (rounds > session->maxrounds)
+        session->maxrounds = rounds;
+    session->sessions++;
+    session->rounds += rounds;
+    session->ticks += ticks;
+    if (winner != -1)
+        session->winners[winner]++;
+    else
+        session->unfinished++;
+}
+
+
+/*==============================
+    tournament_merge
+    Adds the stats of a worker to the total
+    @param  The total stats
+    @param  The worker's stats
+==============================*/
+
+static void tournament_merge(TournamentStats* total, const TournamentStats* add)
+{
+    for (int i=0; i<MAXGAMES; i++)
+    {
+        GameStats* dst = &total->games[i];
+        const GameStats* src = &add->games[i];
+        dst->plays += src->plays;
+        dst->timeouts += src->timeouts;
+        dst->nowinner += src->nowinner;
+        dst->ticks += src->ticks;
+        dst->time_init += src->time_init;
+        dst->time_fixed += src->time_fixed;
+        dst->time_loop += src->time_loop;
+        dst->time_cleanup += src->time_cleanup;
+        for (int d=0; d<DIFFCOUNT; d++)
+        {
+            dst->playsperdiff[d] += src->playsperdiff[d];
+            for (int p=0; p<MAXPLAYERS; p++)
+                dst->wins[d][p] += src->wins[d][p];
+        }
+    }
+    for (int d=0; d<DIFFCOUNT; d++)
+    {
+        for (int m=0; m<MODECOUNT; m++)
+        {
+            SessionStats* dst = &total->sessions[d][m];
+            const SessionStats* src = &add->sessions[d][m];
+            if (src->sessions == 0)
+                continue;
+            if (dst->sessions == 0 || src->minrounds < dst->minrounds)
+                dst->minrounds = src->minrounds;
+            if (src->maxrounds > dst->maxrounds)
+                dst->maxrounds = src->maxrounds;
+            dst->sessions += src->sessions;
+            dst->unfinished += src->unfinished;
+            dst->rounds += src->rounds;
+            dst->ticks += src->ticks;
+            for (int p=0; p<MAXPLAYERS; p++)
+                dst->winners[p] += src->winners[p];
+        }
+    }
+}
+
+
+/*==============================
+    tournament_report
+    Prints the merged stats
+    @param  The stats to print
+    @param  The wall clock time the tournament took, in nanoseconds
+==============================*/
+
+static void tournament_report(const TournamentStats* stats, uint64_t walltime)
+{
+    const float dt = DELTATIME;
+    uint32_t sessioncount = 0;
+
+    printf("\n%-20s %7s %8s %8s %10s %10s %10s %9s\n", "minigame", "plays", "timeout", "nowin", "avg ms", "fixed us", "loop us", "realtime");
+    for (size_t i=0; i<global_minigame_count && i<MAXGAMES; i++)
+    {
+        const GameStats* game = &stats->games[i];
+        uint64_t time = game->time_init + game->time_fixed + game->time_loop + game->time_cleanup;
+        if (game->plays == 0)
+            continue;
+        printf("%-20s %7u %8u %8u %10.2f %10.2f %10.2f %8.0fx\n",
+            global_minigame_list[i].internalname, game->plays, game->timeouts, game->nowinner,
+            (time/1e6)/game->plays,
+            game->ticks ? (game->time_fixed/1e3)/game->ticks : 0.0,
+            game->ticks ? (game->time_loop/1e3)/game->ticks : 0.0,
+            (game->time_fixed + game->time_loop) ? (game->ticks*dt*1e9)/(double)(game->time_fixed + game->time_loop) : 0.0
+        );
+    }
+
+    printf("\nMinigame wins per player slot, by AI difficulty\n");
+    printf("%-20s %-7s %7s %7s %7s %7s %7s\n", "minigame", "diff", "plays", "P1", "P2", "P3", "P4");
+    for (size_t i=0; i<global_minigame_count && i<MAXGAMES; i++)
+    {
+        const GameStats* game = &stats->games[i];
+        for (int d=0; d<DIFFCOUNT; d++)
+        {
+            if (game->playsperdiff[d] == 0)
+                continue;
+            printf("%-20s %-7s %7u", global_minigame_list[i].internalname, global_tournament_diffnames[d], game->playsperdiff[d]);
+            for (int p=0; p<MAXPLAYERS; p++)
+                printf(" %6.1f%%", (100.0*game->wins[d][p])/game->playsperdiff[d]);
+            printf("\n");
+        }
+    }
+
+    printf("\nSessions, by AI difficulty and next round type\n");
+    printf("%-7s %-11s %8s %6s %10s %10s %10s %6s %6s %6s %6s\n", "diff", "mode", "sessions", "unfin", "rounds", "min/max", "sim min", "P1", "P2", "P3", "P4");
+    for (int d=0; d<DIFFCOUNT; d++)
+    {
+        for (int m=0; m<MODECOUNT; m++)
+        {
+            const SessionStats* session = &stats->sessions[d][m];
+            char minmax[32];
+            if (session->sessions == 0)
+                continue;
+            sessioncount += session->sessions;
+            snprintf(minmax, sizeof(minmax), "%u/%u", session->minrounds, session->maxrounds);
+            printf("%-7s %-11s %8u %6u %10.2f %10s %10.2f",
+                global_tournament_diffnames[d], global_tournament_modenames[m], session->sessions, session->unfinished,
+                (double)session->rounds/session->sessions, minmax,
+                (session->ticks*dt/60.0)/session->sessions
+            );
+            for (int p=0; p<MAXPLAYERS; p++)
+                printf(" %5.1f%%", (100.0*session->winners[p])/session->sessions);
+            printf("\n");
+        }
+    }
+    printf("\n%u sessions in %.2f s (%.1f sessions/s)\n", sessioncount, walltime/1e9, walltime ? sessioncount/(walltime/1e9) : 0.0);
+}
+
+
+/*==============================
+    tournament_write
+    Writes a whole buffer to a file descriptor
+    @param  The file descriptor
+    @param  The buffer to write
+    @param  The size of the buffer
+    @return Whether everything was written
+==============================*/
+
+static bool tournament_write(int fd, const void* buf, size_t size)
+{
+    const uint8_t* ptr = buf;
+    while (size > 0)
+    {
+        ssize_t written = write(fd, ptr, size);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return false;
+        ptr += written;
+        size -= written;
+    }
+    return true;
+}
+
+
+/*==============================
+    tournament_read
+    Reads a whole buffer from a file descriptor
+    @param  The file descriptor
+    @param  The buffer to read into
+    @param  The size of the buffer
+    @return Whether everything was read
+==============================*/
+
+static bool tournament_read(int fd, void* buf, size_t size)
+{
+    uint8_t* ptr = buf;
+    while (size > 0)
+    {
+        ssize_t got = read(fd, ptr, size);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            return false;
+        ptr += got;
+        size -= got;
+    }
+    return true;
+}
+
+
+/*==============================
+    main
+    The program main
+==============================*/
+
+int main(int argc, char** argv)
+{
+    TournamentConfig cfg = {DEFAULT_POINTS, DEFAULT_MAXTICKS, DEFAULT_MAXROUNDS, false};
+    uint32_t sessions = DEFAULT_SESSIONS;
+    uint32_t seed = 1;
+    int jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    int onlydiff = -1;
+    int onlymode = -1;
+    static TournamentStats total, part;
+    pid_t* workers;
+    int* pipes;
+    uint64_t start;
+    int failed = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:j:p:s:t:c:a:m:r:f")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': sessions = strtoul(optarg, NULL, 10); break;
+            case 'j': jobs = atoi(optarg); break;
+            case 'p': cfg.points = strtoul(optarg, NULL, 10); break;
+            case 's': seed = strtoul(optarg, NULL, 10); break;
+            case 't': cfg.maxticks = strtoul(optarg, NULL, 10); break;
+            case 'c': cfg.maxrounds = strtoul(optarg, NULL, 10); break;
+            case 'a': onlydiff = atoi(optarg); break;
+            case 'm': onlymode = atoi(optarg); break;
+            case 'r': host_set_romdir(optarg); break;
+            case 'f': cfg.fixedonly = true; break;
+            default: usage(argv[0]);
+        }
+    }
+    if (jobs < 1 || cfg.points < 1 || cfg.points > 7 || onlydiff >= DIFFCOUNT || onlymode >= MODECOUNT)
+        usage(argv[0]);
+
+    // Register every minigame the same way the ROM does, the workers inherit the list
+    minigame_loadall();
+    if (global_minigame_count == 0 || global_minigame_count > MAXGAMES)
+    {
+        fprintf(stderr, "Expected between 1 and %d minigames, found %d\n", MAXGAMES, (int)global_minigame_count);
+        return 1;
+    }
+    core_initlevels();
+    fflush(stdout);
+
+    // Start the workers, each one plays every jobs-th session
+    start = host_time_ns();
+    workers = malloc(sizeof(pid_t)*jobs);
+    pipes = malloc(sizeof(int)*jobs);
+    for (int w=0; w<jobs; w++)
+    {
+        int fds[2];
+        if (pipe(fds) != 0)
+        {
+            perror("pipe");
+            return 1;
+        }
+        workers[w] = fork();
+        if (workers[w] < 0)
+        {
+            perror("fork");
+            return 1;
+        }
+        if (workers[w] == 0)
+        {
+            close(fds[0]);
+            memset(&part, 0, sizeof(part));
+            for (uint32_t i=w; i<sessions; i+=jobs)
+            {
+                AiDiff diff = (onlydiff != -1) ? onlydiff : (AiDiff)(i % DIFFCOUNT);
+                NextRound mode = (onlymode != -1) ? onlymode : (NextRound)((i/DIFFCOUNT) % MODECOUNT);
+                tournament_session(&cfg, diff, mode, seed + i, &part);
+            }
+            _exit(tournament_write(fds[1], &part, sizeof(part)) ? 0 : 1);
+        }
+        close(fds[1]);
+        pipes[w] = fds[0];
+    }
+
+    // Collect the results, a worker that crashed loses all of its sessions
+    for (int w=0; w<jobs; w++)
+    {
+        int status;
+        bool received = tournament_read(pipes[w], &part, sizeof(part));
+        close(pipes[w]);
+        waitpid(workers[w], &status, 0);
+        if (received && WIFEXITED(status) && WEXITSTATUS(status) == 0)
+            tournament_merge(&total, &part);
+        else
+        {
+            if (WIFSIGNALED(status))
+                fprintf(stderr, "Worker %d was killed by signal %d, its sessions are missing from the report\n", w, WTERMSIG(status));
+            else
+                fprintf(stderr, "Worker %d failed, its sessions are missing from the report\n", w);
+            failed++;
+        }
+    }
+    tournament_report(&total, host_time_ns() - start);
+    free(workers);
+    free(pipes);
+    return (failed > 0) ? 1 : 0;
+}
@@ -0,0 +1,539 @@
+/***************************************************************
+                          mkmanifest.c
+
+Host tool that builds the minigame manifest at compile time, so
+the ROM doesn't need to dlopen every minigame DSO at boot just
+to read its minigame_def.
+
+It works in two steps:
+  mkmanifest -e <internalname> -o <file.mfe> <objects...>
+    Finds the object that defines minigame_def, resolves the
+    four string pointers through its relocations and writes the
+    strings to an entry file.
+  mkmanifest -o <manifest> <entries.mfe...>
+    Packs the entries, sorted by internal name, into the
+    manifest that minigame_loadall reads.
+
+The manifest is big endian:
+  char     magic[4]     "MGMF"
+  uint32_t version
+  uint32_t count
+  uint32_t strtabsize
+  uint32_t records[count][5]  String table offsets of the
+                              internalname, gamename,
+                              developername, description and
+                              instructions
+  char     strtab[strtabsize]
+***************************************************************/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+
+/*********************************
+           Definitions
+*********************************/
+
+#define MANIFEST_MAGIC      "MGMF"
+#define MANIFEST_VERSION    1
+#define MANIFEST_FIELDS     5
+#define MAXENTRIES          256
+
+#define ELF_SHT_SYMTAB      2
+#define ELF_SHT_RELA        4
+#define ELF_SHT_REL         9
+#define ELF_SHN_UNDEF       0
+#define ELF_SHN_LORESERVE   0xFF00
+
+#define ELF_EM_386          3
+#define ELF_EM_MIPS         8
+#define ELF_EM_X86_64       62
+#define ELF_EM_AARCH64      183
+
+#define ELF_R_386_32        1
+#define ELF_R_MIPS_32       2
+#define ELF_R_X86_64_64     1
+#define ELF_R_AARCH64_ABS64 257
+
+
+/*********************************
+             Structs
+*********************************/
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    bool is64;
+    bool bigendian;
+    int machine;
+    uint32_t shoff;
+    uint32_t shentsize;
+    uint32_t shnum;
+} ElfFile;
+
+typedef struct {
+    uint32_t type;
+    uint32_t link;
+    uint32_t info;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t entsize;
+} ElfSection;
+
+typedef struct {
+    uint32_t name;
+    uint32_t shndx;
+    uint64_t value;
+} ElfSymbol;
+
+typedef struct {
+    char* strings[MANIFEST_FIELDS];
+} Entry;
+
+
+/*********************************
+             Globals
+*********************************/
+
+static const char* global_fieldnames[MANIFEST_FIELDS] = {"internalname", "gamename", "developername", "description", "instructions"};
+
+
+/*==============================
+    die
+    Prints an error and exits
+    @param  The format string
+    @param  Variable arguments
+==============================*/
+
+static void die(const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "mkmanifest: ");
+    vfprintf(stderr, fmt, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+    exit(1);
+}
+
+
+/*==============================
+    usage
+    Prints the program usage and exits
+    @param  The program name
+==============================*/
+
+static void usage(const char* prog)
+{
+    fprintf(stderr, "Usage: %s -e <internalname> -o <file.mfe> <objects...>\n", prog);
+    fprintf(stderr, "       %s -o <manifest> <entries.mfe...>\n", prog);
+    exit(1);
+}
+
+
+/*==============================
+    readfile
+    Reads a whole file into memory
+    @param  The file path
+    @param  Where to store the file size
+    @return The malloc'd file contents
+==============================*/
+
+static uint8_t* readfile(const char* path, size_t* size)
+{
+    uint8_t* buf;
+    long len;
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+        die("unable to open %s", path);
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    buf = malloc(len + 1);
+    if (fread(buf, 1, len, f) != (size_t)len)
+        die("short read on %s", path);
+    buf[len] = '\0';
+    fclose(f);
+    *size = len;
+    return buf;
+}
+
+
+/*==============================
+    elf_read
+    Reads an unsigned integer from an ELF, in the ELF's endianness
+    @param  The ELF file
+    @param  The offset to read from
+    @param  The size of the integer, in bytes
+    @return The integer
+==============================*/
+
+static uint64_t elf_read(ElfFile* elf, uint64_t offset, int size)
+{
+    uint64_t val = 0;
+    if (offset + size > elf->size)
+        die("read past the end of the object");
+    for (int i=0; i<size; i++)
+    {
+        int shift = elf->bigendian ? (size - 1 - i)*8 : i*8;
+        val |= ((uint64_t)elf->data[offset + i]) << shift;
+    }
+    return val;
+}
+
+
+/*==============================
+    elf_open
+    Parses the header of a relocatable ELF object
+    @param  The ELF file to fill
+    @param  The file contents
+    @param  The file size
+    @return Whether the file is a supported ELF object
+==============================*/
+
+static bool elf_open(ElfFile* elf, uint8_t* data, size_t size)
+{
+    if (size < 52 || memcmp(data, "\x7F" "ELF", 4))
+        return false;
+    elf->data = data;
+    elf->size = size;
+    elf->is64 = (data[4] == 2);
+    elf->bigendian = (data[5] == 2);
+    elf->machine = elf_read(elf, 18, 2);
+    if (elf->is64)
+    {
+        elf->shoff     = elf_read(elf, 40, 8);
+        elf->shentsize = elf_read(elf, 58, 2);
+        elf->shnum     = elf_read(elf, 60, 2);
+    }
+    else
+    {
+        elf->shoff     = elf_read(elf, 32, 4);
+        elf->shentsize = elf_read(elf, 46, 2);
+        elf->shnum     = elf_read(elf, 48, 2);
+    }
+    return true;
+}
+
+
+/*==============================
+    elf_section
+    Reads a section header
+    @param  The ELF file
+    @param  The section index
+    @return The section header
+==============================*/
+
+static ElfSection elf_section(ElfFile* elf, uint32_t index)
+{
+    ElfSection sec;
+    uint64_t base = elf->shoff + (uint64_t)index*elf->shentsize;
+    if (index >= elf->shnum)
+        die("section index %u out of range", index);
+    sec.type = elf_read(elf, base + 4, 4);
+    if (elf->is64)
+    {
+        sec.offset  = elf_read(elf, base + 24, 8);
+        sec.size    = elf_read(elf, base + 32, 8);
+        sec.link    = elf_read(elf, base + 40, 4);
+        sec.info    = elf_read(elf, base + 44, 4);
+        sec.entsize = elf_read(elf, base + 56, 8);
+    }
+    else
+    {
+        sec.offset  = elf_read(elf, base + 16, 4);
+        sec.size    = elf_read(elf, base + 20, 4);
+        sec.link    = elf_read(elf, base + 24, 4);
+        sec.info    = elf_read(elf, base + 28, 4);
+        sec.entsize = elf_read(elf, base + 36, 4);
+    }
+    return sec;
+}
+
+
+/*==============================
+    elf_symbol
+    Reads a symbol from a symbol table
+    @param  The ELF file
+    @param  The symbol table section
+    @param  The symbol index
+    @return The symbol
+==============================*/
+
+static ElfSymbol elf_symbol(ElfFile* elf, ElfSection* symtab, uint32_t index)
+{
+    ElfSymbol sym;
+    uint64_t base = symtab->offset + (uint64_t)index*symtab->entsize;
+    sym.name = elf_read(elf, base, 4);
+    if (elf->is64)
+    {
+        sym.shndx = elf_read(elf, base + 6, 2);
+        sym.value = elf_read(elf, base + 8, 8);
+    }
+    else
+    {
+        sym.value = elf_read(elf, base + 4, 4);
+        sym.shndx = elf_read(elf, base + 14, 2);
+    }
+    return sym;
+}
+
+
+/*==============================
+    elf_findsymbol
+    Finds a defined symbol by name
+    @param  The ELF file
+    @param  The name of the symbol
+    @param  Where to store the symbol table section
+    @param  Where to store the symbol
+    @return Whether the symbol was found
+==============================*/
+
+static bool elf_findsymbol(ElfFile* elf, const char* name, ElfSection* outsymtab, ElfSymbol* outsym)
+{
+    for (uint32_t i=0; i<elf->shnum; i++)
+    {
+        ElfSection symtab = elf_section(elf, i);
+        ElfSection strtab;
+        if (symtab.type != ELF_SHT_SYMTAB)
+            continue;
+        strtab = elf_section(elf, symtab.link);
+        for (uint32_t j=1; j<symtab.size/symtab.entsize; j++)
+        {
+            ElfSymbol sym = elf_symbol(elf, &symtab, j);
+            if (sym.shndx == ELF_SHN_UNDEF || sym.shndx >= ELF_SHN_LORESERVE || sym.name >= strtab.size)
+                continue;
+            if (!strcmp((char*)elf->data + strtab.offset + sym.name, name))
+            {
+                *outsymtab = symtab;
+                *outsym = sym;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+/*==============================
+    elf_resolvestring
+    Follows the relocation at a pointer inside a section to the
+    string it points to
+    @param  The ELF file
+    @param  The symbol table the relocations refer to
+    @param  The index of the section holding the pointer
+    @param  The offset of the pointer in that section
+    @return A pointer to the string inside the ELF data
+==============================*/
+
+static const char* elf_resolvestring(ElfFile* elf, ElfSection* symtab, uint32_t shndx, uint64_t offset)
+{
+    const int ptrsize = elf->is64 ? 8 : 4;
+    for (uint32_t i=0; i<elf->shnum; i++)
+    {
+        ElfSection relsec = elf_section(elf, i);
+        if ((relsec.type != ELF_SHT_REL && relsec.type != ELF_SHT_RELA) || relsec.info != shndx)
+            continue;
+        for (uint32_t j=0; j<relsec.size/relsec.entsize; j++)
+        {
+            uint64_t base = relsec.offset + (uint64_t)j*relsec.entsize;
+            uint64_t roffset = elf_read(elf, base, ptrsize);
+            uint64_t rinfo = elf_read(elf, base + ptrsize, ptrsize);
+            uint32_t rsym = elf->is64 ? (rinfo >> 32) : (rinfo >> 8);
+            uint32_t rtype = elf->is64 ? (rinfo & 0xFFFFFFFF) : (rinfo & 0xFF);
+            uint64_t addend;
+            ElfSymbol target;
+            ElfSection targetsec;
+            if (roffset != offset)
+                continue;
+
+            // Only plain absolute pointers are expected in a static initializer
+            if (!((elf->machine == ELF_EM_MIPS && !elf->is64 && rtype == ELF_R_MIPS_32) ||
+                  (elf->machine == ELF_EM_386 && rtype == ELF_R_386_32) ||
+                  (elf->machine == ELF_EM_X86_64 && rtype == ELF_R_X86_64_64) ||
+                  (elf->machine == ELF_EM_AARCH64 && rtype == ELF_R_AARCH64_ABS64)))
+                die("unsupported relocation type %u on machine %d", rtype, elf->machine);
+
+            // REL keeps the addend in place, RELA stores it in the entry
+            if (relsec.type == ELF_SHT_RELA)
+                addend = elf_read(elf, base + ptrsize*2, ptrsize);
+            else
+                addend = elf_read(elf, elf_section(elf, shndx).offset + offset, ptrsize);
+
+            target = elf_symbol(elf, symtab, rsym);
+            if (target.shndx == ELF_SHN_UNDEF || target.shndx >= ELF_SHN_LORESERVE)
+                die("minigame_def points to a string outside of its object");
+            targetsec = elf_section(elf, target.shndx);
+            offset = (target.value + addend) & (elf->is64 ? UINT64_MAX : UINT32_MAX);
+            if (offset >= targetsec.size || memchr(elf->data + targetsec.offset + offset, '\0', targetsec.size - offset) == NULL)
+                die("minigame_def points to an invalid string");
+            return (const char*)elf->data + targetsec.offset + offset;
+        }
+    }
+    return NULL;
+}
+
+
+/*==============================
+    make_entry
+    Extracts minigame_def from a list of objects
+    @param  The internal name of the minigame
+    @param  The entry file to write
+    @param  The number of objects
+    @param  The object paths
+==============================*/
+
+static void make_entry(const char* name, const char* outpath, int count, char** objects)
+{
+    for (int i=0; i<count; i++)
+    {
+        size_t size;
+        ElfFile elf;
+        ElfSection symtab;
+        ElfSymbol sym;
+        FILE* out;
+        uint8_t* data = readfile(objects[i], &size);
+        if (!elf_open(&elf, data, size) || !elf_findsymbol(&elf, "minigame_def", &symtab, &sym))
+        {
+            free(data);
+            continue;
+        }
+
+        // Write the internal name followed by each string in the definition
+        out = fopen(outpath, "wb");
+        if (out == NULL)
+            die("unable to create %s", outpath);
+        fwrite(name, 1, strlen(name) + 1, out);
+        for (int j=1; j<MANIFEST_FIELDS; j++)
+        {
+            const char* str = elf_resolvestring(&elf, &symtab, sym.shndx, sym.value + (j-1)*(elf.is64 ? 8 : 4));
+            if (str == NULL)
+                die("%s: minigame_def.%s is not set", objects[i], global_fieldnames[j]);
+            fwrite(str, 1, strlen(str) + 1, out);
+        }
+        fclose(out);
+        free(data);
+        return;
+    }
+    die("no object of minigame '%s' defines minigame_def", name);
+}
+
+
+/*==============================
+    write_u32
+    Writes a big endian 32-bit integer
+    @param  The file to write to
+    @param  The value to write
+==============================*/
+
+static void write_u32(FILE* f, uint32_t val)
+{
+    uint8_t buf[4] = {val >> 24, val >> 16, val >> 8, val};
+    fwrite(buf, 1, 4, f);
+}
+
+
+/*==============================
+    compare_entries
+    qsort comparator that orders entries by internal name
+==============================*/
+
+static int compare_entries(const void* a, const void* b)
+{
+    return strcmp(((const Entry*)a)->strings[0], ((const Entry*)b)->strings[0]);
+}
+
+
+/*==============================
+    make_manifest
+    Packs entry files into the manifest
+    @param  The manifest file to write
+    @param  The number of entries
+    @param  The entry paths
+==============================*/
+
+static void make_manifest(const char* outpath, int count, char** entries)
+{
+    static Entry list[MAXENTRIES];
+    uint32_t strtabsize = 0;
+    FILE* out;
+    if (count > MAXENTRIES)
+        die("too many minigames (%d, max %d)", count, MAXENTRIES);
+
+    // Split each entry file into its strings
+    for (int i=0; i<count; i++)
+    {
+        size_t size;
+        char* data = (char*)readfile(entries[i], &size);
+        char* str = data;
+        for (int j=0; j<MANIFEST_FIELDS; j++)
+        {
+            if (str >= data + size)
+                die("%s is truncated", entries[i]);
+            list[i].strings[j] = str;
+            str += strlen(str) + 1;
+        }
+    }
+    qsort(list, count, sizeof(Entry), compare_entries);
+
+    // Write the header and the fixed size records
+    out = fopen(outpath, "wb");
+    if (out == NULL)
+        die("unable to create %s", outpath);
+    for (int i=0; i<count; i++)
+        for (int j=0; j<MANIFEST_FIELDS; j++)
+            strtabsize += strlen(list[i].strings[j]) + 1;
+    fwrite(MANIFEST_MAGIC, 1, 4, out);
+    write_u32(out, MANIFEST_VERSION);
+    write_u32(out, count);
+    write_u32(out, strtabsize);
+    strtabsize = 0;
+    for (int i=0; i<count; i++)
+    {
+        for (int j=0; j<MANIFEST_FIELDS; j++)
+        {
+            write_u32(out, strtabsize);
+            strtabsize += strlen(list[i].strings[j]) + 1;
+        }
+    }
+
+    // Write the string table
+    for (int i=0; i<count; i++)
+        for (int j=0; j<MANIFEST_FIELDS; j++)
+            fwrite(list[i].strings[j], 1, strlen(list[i].strings[j]) + 1, out);
+    fclose(out);
+}
+
+
+/*==============================
+    main
+    The program main
+==============================*/
+
+int main(int argc, char** argv)
+{
+    const char* name = NULL;
+    const char* outpath = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "e:o:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'e': name = optarg; break;
+            case 'o': outpath = optarg; break;
+            default: usage(argv[0]);
+        }
+    }
+    if (outpath == NULL)
+        usage(argv[0]);
+    if (name != NULL)
+        make_entry(name, outpath, argc - optind, argv + optind);
+    else
+        make_manifest(outpath, argc - optind, argv + optind);
+    return 0;
+}